@@ -0,0 +1,123 @@
+#include "Bitboard.h"
+
+// How the sliders move, as {row, col} steps repeated until blocked
+static constexpr int bishopDirections[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+static constexpr int rookDirections[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+static Bitboard slidingAttacks(int square, Bitboard occupied, const int (&directions)[4][2]){
+    Bitboard attacks = 0;
+    for(const auto &direction : directions){
+        int row = rowOf(square) + direction[0];
+        int col = colOf(square) + direction[1];
+        // Walk the ray until it leaves the board, the first blocker is included
+        while(row >= 0 && row < 8 && col >= 0 && col < 8){
+            attacks |= squareBB(squareOf(row, col));
+            if(occupied & squareBB(squareOf(row, col))) break;
+            row += direction[0];
+            col += direction[1];
+        }
+    }
+    return attacks;
+}
+
+Magic bishopMagics[64];
+Magic rookMagics[64];
+
+// Every square's slot count summed over the board (2^relevant blockers per square)
+static Bitboard bishopTable[0x1480];
+static Bitboard rookTable[0x19000];
+
+static void initMagics(Magic (&magics)[64], Bitboard* table, const int (&directions)[4][2]){
+    const Bitboard rank1 = 0xFFULL, rank8 = rank1 << 56;
+    const Bitboard fileA = 0x0101010101010101ULL, fileH = fileA << 7;
+    Bitboard reference[4096];
+#ifndef __BMI2__
+    // only the magic search needs these, PEXT indexes the tables directly
+    Bitboard occupancies[4096];
+    int epoch[4096] = {};
+    int attempt = 0;
+    // fixed seed, so the same magics are found on every run
+    uint64_t seed = 1070372;
+    auto random = [&seed](){
+        seed ^= seed >> 12; seed ^= seed << 25; seed ^= seed >> 27;
+        return seed * 2685821657736338717ULL;
+    };
+#endif
+
+    for(int square = 0; square < 64; square++){
+        // Blockers on the board edge never change the attacks, so they are left out of the mask
+        Bitboard edges = ((rank1 | rank8) & ~(rank1 << (8 * rowOf(square)))) | ((fileA | fileH) & ~(fileA << colOf(square)));
+        Magic &m = magics[square];
+        m.mask = slidingAttacks(square, 0, directions) & ~edges;
+        m.shift = 64 - popCount(m.mask);
+        m.attacks = square == 0 ? table : magics[square - 1].attacks + (1 << (64 - magics[square - 1].shift));
+        Bitboard* attacks = const_cast<Bitboard*>(m.attacks);
+
+        // Enumerate every subset of the mask (Carry-Rippler) with its true attacks
+        int size = 0;
+        Bitboard blockers = 0;
+        do {
+            reference[size] = slidingAttacks(square, blockers, directions);
+#ifdef __BMI2__
+            attacks[_pext_u64(blockers, m.mask)] = reference[size];
+#else
+            occupancies[size] = blockers;
+#endif
+            size++;
+            blockers = (blockers - m.mask) & m.mask;
+        } while(blockers);
+
+#ifndef __BMI2__
+        // Try sparse random numbers until one maps every subset without a harmful collision
+        for(int i = 0; i < size; ){
+            do {
+                m.magic = random() & random() & random();
+            } while(popCount((m.magic * m.mask) >> 56) < 6);
+            attempt++;
+            for(i = 0; i < size; i++){
+                unsigned index = m.index(occupancies[i]);
+                if(epoch[index] < attempt){
+                    epoch[index] = attempt;
+                    attacks[index] = reference[i];
+                }
+                else if(attacks[index] != reference[i]){
+                    break;
+                }
+            }
+        }
+#endif
+    }
+}
+
+// Filled before main runs, nothing looks up slider attacks during static initialization
+static const bool magicsInitialized = [](){
+    initMagics(bishopMagics, bishopTable, bishopDirections);
+    initMagics(rookMagics, rookTable, rookDirections);
+    return true;
+}();
+
+constexpr RayTables rays = [](){
+    constexpr int directions[8][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}, {1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    auto ray = [](int square, int rowStep, int colStep){
+        Bitboard squares = 0;
+        for(int row = rowOf(square) + rowStep, col = colOf(square) + colStep; row >= 0 && row < 8 && col >= 0 && col < 8; row += rowStep, col += colStep){
+            squares |= squareBB(squareOf(row, col));
+        }
+        return squares;
+    };
+    RayTables tables{};
+    for(int from = 0; from < 64; from++){
+        for(const auto &direction : directions){
+            Bitboard line = squareBB(from) | ray(from, direction[0], direction[1]) | ray(from, -direction[0], -direction[1]);
+            // walking outwards, the squares passed so far are the ones between
+            Bitboard between = 0;
+            for(int row = rowOf(from) + direction[0], col = colOf(from) + direction[1]; row >= 0 && row < 8 && col >= 0 && col < 8; row += direction[0], col += direction[1]){
+                int to = squareOf(row, col);
+                tables.between[from][to] = between;
+                tables.line[from][to] = line;
+                between |= squareBB(to);
+            }
+        }
+    }
+    return tables;
+}();
@@ -0,0 +1,144 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include <bit>
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+// One bit per square, a1 = bit 0, h1 = bit 7, a8 = bit 56 (square = row * 8 + col)
+using Bitboard = uint64_t;
+
+enum Colour { WHITE, BLACK };
+enum PieceType { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING };
+
+inline constexpr int NO_PIECE = -1;
+inline constexpr int NO_SQUARE = -1;
+
+// Pieces are indexed colour * 6 + type, so all white pieces come first
+constexpr int pieceIndex(Colour colour, PieceType type){ return colour * 6 + type; }
+constexpr Colour colourOf(int piece){ return piece < 6 ? WHITE : BLACK; }
+constexpr PieceType typeOf(int piece){ return static_cast<PieceType>(piece % 6); }
+constexpr Colour opposite(Colour colour){ return colour == WHITE ? BLACK : WHITE; }
+
+constexpr int squareOf(int row, int col){ return row * 8 + col; }
+constexpr int rowOf(int square){ return square >> 3; }
+constexpr int colOf(int square){ return square & 7; }
+constexpr Bitboard squareBB(int square){ return Bitboard{1} << square; }
+
+inline constexpr Bitboard FILE_A = 0x0101010101010101ULL;
+inline constexpr Bitboard FILE_H = FILE_A << 7;
+inline constexpr Bitboard RANK_1 = 0xFFULL;
+
+// Rows counted from a side's own back rank, so the pawns of either side start on relative row 1
+template<Colour Us> constexpr int relativeRow(int row){ return Us == WHITE ? row : 7 - row; }
+template<Colour Us> constexpr Bitboard relativeRank(int row){ return RANK_1 << (8 * relativeRow<Us>(row)); }
+// One step towards the enemy back rank
+template<Colour Us> inline constexpr int pawnPush = Us == WHITE ? 8 : -8;
+
+// Every square of the set moved Step squares, dropping those that would wrap around the board edge
+template<int Step> constexpr Bitboard shift(Bitboard b){
+    static_assert(Step == 8 || Step == -8 || Step == 7 || Step == -7 || Step == 9 || Step == -9, "one step in any direction but sideways");
+    if constexpr (Step == 8) return b << 8;
+    else if constexpr (Step == -8) return b >> 8;
+    else if constexpr (Step == 9) return (b << 9) & ~FILE_A;
+    else if constexpr (Step == 7) return (b << 7) & ~FILE_H;
+    else if constexpr (Step == -7) return (b >> 7) & ~FILE_A;
+    else return (b >> 9) & ~FILE_H;
+}
+// Squares attacked by a whole set of pawns at once
+template<Colour Us> constexpr Bitboard pawnAttacks(Bitboard pawns){
+    return shift<pawnPush<Us> - 1>(pawns) | shift<pawnPush<Us> + 1>(pawns);
+}
+
+inline int popCount(Bitboard b){ return std::popcount(b); }
+inline int lsb(Bitboard b){ return std::countr_zero(b); }
+inline int popLsb(Bitboard &b){
+    int square = lsb(b);
+    b &= b - 1;
+    return square;
+}
+
+// Attacks of the pieces that step rather than slide, for every square
+struct LeaperAttacks {
+    Bitboard pawn[2][64];
+    Bitboard knight[64];
+    Bitboard king[64];
+};
+
+// Worked out by the compiler from each piece's {row, col} steps, so a lookup needs no setup at startup
+inline constexpr LeaperAttacks leaperAttacks = [](){
+    constexpr int pawnDeltas[2][2][2] = {{{1, 1}, {1, -1}}, {{-1, 1}, {-1, -1}}};
+    constexpr int knightDeltas[8][2] = {{1, 2}, {-1, 2}, {1, -2}, {-1, -2}, {2, 1}, {-2, 1}, {2, -1}, {-2, -1}};
+    constexpr int kingDeltas[8][2] = {{0, 1}, {0, -1}, {1, 0}, {1, 1}, {1, -1}, {-1, 0}, {-1, 1}, {-1, -1}};
+    auto attacks = [](int square, const auto &deltas){
+        Bitboard targets = 0;
+        for(const auto &delta : deltas){
+            int row = rowOf(square) + delta[0];
+            int col = colOf(square) + delta[1];
+            if(row >= 0 && row < 8 && col >= 0 && col < 8){
+                targets |= squareBB(squareOf(row, col));
+            }
+        }
+        return targets;
+    };
+    LeaperAttacks tables{};
+    for(int square = 0; square < 64; square++){
+        tables.pawn[WHITE][square] = attacks(square, pawnDeltas[WHITE]);
+        tables.pawn[BLACK][square] = attacks(square, pawnDeltas[BLACK]);
+        tables.knight[square] = attacks(square, knightDeltas);
+        tables.king[square] = attacks(square, kingDeltas);
+    }
+    return tables;
+}();
+
+inline Bitboard pawnAttacks(Colour colour, int square){ return leaperAttacks.pawn[colour][square]; }
+inline Bitboard knightAttacks(int square){ return leaperAttacks.knight[square]; }
+inline Bitboard kingAttacks(int square){ return leaperAttacks.king[square]; }
+
+// Slider attacks are looked up in tables filled once at startup. The relevant
+// blockers of a square are hashed to a table slot with a magic multiply, or
+// with a single PEXT instruction when the build targets BMI2.
+struct Magic {
+    Bitboard mask;
+    Bitboard magic;
+    const Bitboard* attacks;
+    unsigned shift;
+    unsigned index(Bitboard occupied) const {
+#ifdef __BMI2__
+        return _pext_u64(occupied, mask);
+#else
+        return ((occupied & mask) * magic) >> shift;
+#endif
+    }
+};
+
+extern Magic bishopMagics[64];
+extern Magic rookMagics[64];
+
+inline Bitboard bishopAttacks(int square, Bitboard occupied){
+    const Magic &m = bishopMagics[square];
+    return m.attacks[m.index(occupied)];
+}
+inline Bitboard rookAttacks(int square, Bitboard occupied){
+    const Magic &m = rookMagics[square];
+    return m.attacks[m.index(occupied)];
+}
+inline Bitboard queenAttacks(int square, Bitboard occupied){
+    return bishopAttacks(square, occupied) | rookAttacks(square, occupied);
+}
+
+// Ray masks for every pair of squares, indexed [from][to]. Filled at compile time in Bitboard.cc
+struct RayTables {
+    // Squares strictly between two squares on a shared row, column or diagonal, empty otherwise
+    Bitboard between[64][64];
+    // The whole row, column or diagonal through both squares, empty if they are not aligned
+    Bitboard line[64][64];
+};
+extern const RayTables rays;
+
+inline Bitboard betweenSquares(int from, int to){ return rays.between[from][to]; }
+inline Bitboard lineThrough(int from, int to){ return rays.line[from][to]; }
+
+#endif
@@ -7,23 +7,37 @@
 #include <set>
 #include <unordered_set>
 #include <memory>
-#include "Computer.h"
+#include <vector>
+#include "Bitboard.h"
+#include "Move.h"
+#include "Position.h"
 
+// The game session: the position being played plus everything around it that observers and
+// players see. Search and validation work on copies of the Position, never on the board
 class Chessboard : public Subject{
     public:
         inline static const size_t BOARD_SIZE = 8;
         Chessboard();
-        Chessboard(const Chessboard &other);
         void addPiece(std::string cmd);
         void removePiece(std::string cmd);
         void setColour(std::string cmd);
-        bool executeMove(std::string cmd, std::string playerId);
+        void loadFen(std::string fen);
+        bool executeMove(Move move, std::string playerId);
+        // Take back the last move played, or play again the last move taken back
+        void undoMove();
+        void redoMove();
         std::string getWinner();
         bool validChessboard();
-        std::pair<const Piece*, const Piece*> getState(size_t row, size_t col) const override;
+        Piece getState(size_t row, size_t col) const override;
+        Bitboard getChangedSquares() const override;
+        void notifyObservers() override;
         void clearChessboard();
         void initChessboard();
         void getValidPlayerIds(std::string (&ids)[2]);
+        Move parseMove(std::string cmd) const;
+        const Position& getPosition() const;
+        // Zobrist key of the current position
+        uint64_t hash() const;
         ~Chessboard();
     private:
         static const std::unordered_set<char> validWhitePieceInputs;
@@ -32,28 +46,32 @@ class Chessboard : public Subject{
         static const std::unordered_set<char> gridLetters;
         static const std::unordered_set<char> promotedWhitePieces;
         static const std::unordered_set<char> promotedBlackPieces;
-        bool validPiece(std::string piece);
-        bool validGridPosition(std::string position);
-        bool isBlackPiece(std::string piece);
-        bool isWhitePiece(std::string piece);
-        bool validPromotionPiece(std::string piece, char color);
-        bool isBlackPromotionPiece(std::string piece);
-        bool isWhitePromotionPiece(std::string piece);
-        std::unique_ptr<Piece> createPiece(std::string piece, char colour);
-        void makeMove(int startRow, int startCol, int endRow, int endCol, bool enPassant = false);
-        bool isKingInCheck(char piece);
-        bool isPieceBeingAttacked(int x, int y, char colour);
-        bool isStraightClear(int startRow, int startCol, int endRow, int endCol);
-        bool isDiagonalClear(int startRow, int startCol, int endRow, int endCol);
-        void getAllMoves(std::string playerId, std::vector<std::string> &validMoves) const;
-        bool isTemporary;
-        std::unique_ptr<Piece> board[BOARD_SIZE][BOARD_SIZE];
-        std::unique_ptr<Piece> prevBoard[BOARD_SIZE][BOARD_SIZE];
+        bool validPiece(std::string piece) const;
+        bool validGridPosition(std::string position) const;
+        bool isBlackPiece(std::string piece) const;
+        bool isWhitePiece(std::string piece) const;
+        bool validPromotionPiece(std::string piece, char color) const;
+        bool isBlackPromotionPiece(std::string piece) const;
+        bool isWhitePromotionPiece(std::string piece) const;
+        int createPiece(std::string piece, char colour) const;
+        void checkMove(Move move, Colour player);
+        static Bitboard squaresTouched(Move move);
+        void clearJournal();
+        Position position;
+        // One entry per move played this game, enough for unmakeMove to restore the position
+        struct JournalEntry {
+            Move move;
+            Undo undo;
+        };
+        std::vector<JournalEntry> history;
+        // moves taken back with undoMove, the next to redo last, dropped when a new move is played
+        std::vector<Move> undone;
+        // squares touched since observers were last notified, so they redraw only those
+        Bitboard changedSquares;
+        // whether the board being set up came from a FEN, whose castling rights setup edits may only take away
+        bool fenLoaded;
         std::string winner;
         std::string validPlayerIds[2] = {"White", "Black"};
-        void updateBackup();
-        int fiftyMoveDrawCount;
-        friend class Computer;
 };
 
 #endif
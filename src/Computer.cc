@@ -1,80 +1,90 @@
 #include "Computer.h"
 #include "Chessboard.h"
 #include "Piece.h"
-#include "Pawn.h"
-#include "Knight.h"
+#include "MoveGenerator.h"
 #include <random>
 #include <chrono>
 #include "exceptions/InternalErrorException.h"
 #include <iostream>
 
-const std::unordered_map<char, int> Computer::supportedLevels = {{'1', 1}, {'2', 2}, {'3', 3}, {'4', 4}};
+const std::unordered_map<char, int> Computer::supportedLevels = {{'1', 1}, {'2', 2}, {'3', 3}, {'4', 4}, {'5', 5}};
 
-const std::unordered_map<char, int> Computer::pieceValues = {{'K', 0}, {'P', 1}, {'N', 3}, {'B', 3}, {'R', 5}, {'Q', 9}};
+// Level 4 looks one move ahead and follows the exchanges that start, level 5 searches as far as its options allow
+static std::unique_ptr<Search> searchFor(int level, SearchOptions options){
+    if(level == 4){
+        SearchOptions oneMove;
+        oneMove.depth = 1;
+        oneMove.hash = 1;
+        return std::make_unique<Search>(oneMove);
+    }
+    if(level == 5){
+        if(!options.depth && !options.nodes){
+            options.nodes = Computer::DEFAULT_NODES;
+        }
+        return std::make_unique<Search>(options);
+    }
+    return nullptr;
+}
+
+Computer::Computer(std::string id, int level, SearchOptions options) : Player{id}, level{level}, search{searchFor(level, options)} {}
 
-Computer::Computer(std::string id, int level) : Player{id}, level{level} {}
+Colour Computer::colour(){
+    return toupper(getId()[0]) == 'W' ? WHITE : BLACK;
+}
 
-std::string Computer::getMove(const Chessboard* board) {
+Move Computer::getMove(const Chessboard* board) {
+    // One scratch copy of the position per decision, the levels try their candidates on it with makeMove/unmakeMove
+    Position copy = board->getPosition();
     if(level == 1){
-        return level1Move(board);
+        return level1Move(&copy);
     }
     else if(level == 2){
-        return level2Move(board);
+        return level2Move(&copy);
     }
     else if(level == 3){
-        return level3Move(board);
+        return level3Move(&copy);
     }
     else if(level == 4){
-        return level4Move(board);
+        return level4Move(&copy);
+    }
+    else if(level == 5){
+        return level5Move(&copy);
     }
-    return "";
+    return Move{};
 }
 
-std::string Computer::level1Move(const Chessboard* board){
-    std::vector<std::string> validMoves;
-    board->getAllMoves(getId(), validMoves);
+Move Computer::level1Move(Position* board){
+    MoveList validMoves = board->getAllMoves(colour());
     if(validMoves.empty()){
         throw InternalErrorException{"Computer generated no moves"};
     }
     // Pick a move at random
     std::default_random_engine generator(std::chrono::system_clock::now().time_since_epoch().count());
     std::uniform_int_distribution<int> distribution(0, validMoves.size() - 1);
-    std::string move = validMoves[distribution(generator)];
+    Move move = validMoves[distribution(generator)];
     return move;
 }
 
-std::string Computer::level2Move(const Chessboard* board){
-    std::vector<std::string> validMoves;
-    board->getAllMoves(getId(), validMoves);
-    std::vector<std::string> preferredMoves;
-    for(const std::string &move : validMoves){
-        int row, col;
-
-        col = move[3] - 'a';
-        row = move[4] - '1';
-
-        // Check if move is capturing
-        const Piece* pieceAtDest = board->getState(row, col).first;
-        if(pieceAtDest != nullptr && pieceAtDest->getColour() != toupper(getId()[0])){
-            preferredMoves.push_back(move);
+Move Computer::level2Move(Position* board){
+    MoveList validMoves;
+    MoveList preferredMoves;
+    MoveGenerator candidates{*board};
+    Move candidate;
+    while(candidates.next(candidate)){
+        validMoves.push_back(candidate);
+        // Captures and promotions, the generator hands these out before any quiet move
+        if(candidates.currentStage() == CAPTURES){
+            preferredMoves.push_back(candidate);
             continue;
         }
 
         // Check if move is a check
-        Chessboard copy = *board;
-        copy.executeMove(move, getId());
-        if(copy.isKingInCheck(toupper(getId()[0]) == 'W' ? 'B' : 'W')){
-            preferredMoves.push_back(move);
-            continue;
-        }
-        
-        // Pawn promotion
-        if(move.size() > 5){
-            preferredMoves.push_back(move);
+        if(board->givesCheck(candidate)){
+            preferredMoves.push_back(candidate);
             continue;
         }
     }
-    std::string move;
+    Move move;
     if(preferredMoves.empty()){
         if(validMoves.empty()){
             throw InternalErrorException{"Computer generated no moves"};
@@ -93,67 +103,49 @@ std::string Computer::level2Move(const Chessboard* board){
     return move;
 }
 
-std::string Computer::level3Move(const Chessboard* board){
-    std::vector<std::string> validMoves;
-    board->getAllMoves(getId(), validMoves);
-    std::vector<std::string> prunedValidMoves;
-    std::vector<std::string> preferredMoves;
-    std::vector<std::string> morePreferredMoves;
-    for(const std::string &move : validMoves){
-        int row, col;
-        col = move[3] - 'a';
-        row = move[4] - '1';
-
-        int originalRow, originalCol;
-        originalCol = move[0] - 'a';
-        originalRow = move[1] - '1'; 
-
-        {
-            Chessboard copy = *board;
-            if(!copy.isPieceBeingAttacked(col, row, toupper(getId()[0]))){
-                copy.isPieceBeingAttacked(col, row, toupper(getId()[0]));
-                prunedValidMoves.push_back(move);
-            }
+Move Computer::level3Move(Position* board){
+    MoveList validMoves;
+    MoveList prunedValidMoves;
+    MoveList preferredMoves;
+    MoveList morePreferredMoves;
+    MoveGenerator candidates{*board};
+    Move candidate;
+    while(candidates.next(candidate)){
+        validMoves.push_back(candidate);
+        if(!board->isSquareAttacked(candidate.to(), opposite(colour()))){
+            prunedValidMoves.push_back(candidate);
         }
 
         // Check if move avoids capture
-        {
-            Chessboard copy = *board;
-            if(copy.isPieceBeingAttacked(originalCol, originalRow, toupper(getId()[0]))){
-                copy.executeMove(move, getId());
-                if(!copy.isPieceBeingAttacked(col, row, toupper(getId()[0]))){
-                    morePreferredMoves.push_back(move);
-                }
+        if(board->isSquareAttacked(candidate.from(), opposite(colour()))){
+            Undo undo = board->makeMove(candidate);
+            if(!board->isSquareAttacked(candidate.to(), opposite(colour()))){
+                morePreferredMoves.push_back(candidate);
             }
+            board->unmakeMove(candidate, undo);
         }
 
-        // Check if move is capturing
-        const Piece* pieceAtDest = board->getState(row, col).first;
-        if(pieceAtDest != nullptr && pieceAtDest->getColour() != toupper(getId()[0])){
-            preferredMoves.push_back(move);
-            continue;
-        }
-
-        // Pawn promotion
-        if(move.size() > 5){
-            preferredMoves.push_back(move);
+        // Captures and promotions, the generator hands these out before any quiet move
+        if(candidates.currentStage() == CAPTURES){
+            preferredMoves.push_back(candidate);
             continue;
         }
 
         // Check if move is a check
-        {
-            Chessboard copy = *board;        
-            copy.executeMove(move, getId());
+        if(board->givesCheck(candidate)){
+            Undo undo = board->makeMove(candidate);
 
             // We don't want to give up a piece for a check
-            if(copy.isKingInCheck(toupper(getId()[0]) == 'W' ? 'B' : 'W') && !copy.isPieceBeingAttacked(col, row, toupper(getId()[0]))){
-                preferredMoves.push_back(move);
+            bool safeCheck = !board->isSquareAttacked(candidate.to(), opposite(colour()));
+            board->unmakeMove(candidate, undo);
+            if(safeCheck){
+                preferredMoves.push_back(candidate);
                 continue;
             }
         }
     }
     if(!prunedValidMoves.empty()) validMoves = prunedValidMoves;
-    std::string move;
+    Move move;
     if(morePreferredMoves.empty()){
         if(preferredMoves.empty()){
             if(validMoves.empty()){
@@ -180,96 +172,12 @@ std::string Computer::level3Move(const Chessboard* board){
     return move;
 }
 
-int Computer::EndOfGameScore(Chessboard* board){
-    int score = -1;
-    std::vector<std::string> validMoves;
-    board->getAllMoves(toupper(getId()[0]) == 'W' ? "black" : "white", validMoves);
-    if(validMoves.size() == 0){
-        // Checkmate if other king in check, stalemate otherwise
-        if(board->isKingInCheck(toupper(getId()[0]) == 'W' ? 'B' : 'W')){
-            score = 10000;
-        }
-        else{
-            score = 0; 
-        }
-    }
-    // check for dead position
-    int numBishopOrKnight = 0;
-    bool twoBishopDeadPos = false;
-    std::pair<int, int> tmpBishopPos = {-1, -1};
-    for(size_t i = 0; i < Chessboard::BOARD_SIZE; i++){
-        for(size_t j = 0; j < Chessboard::BOARD_SIZE; j++){
-            if(board->board[i][j] != nullptr && (toupper(board->board[i][j]->getName()) == 'B' || toupper(board->board[i][j]->getName()) == 'N')){
-                if(tmpBishopPos.first == -1) tmpBishopPos = std::pair<int, int>(i, j);
-                else if(((Chessboard::BOARD_SIZE - i - 1) + j) % 2 == (((Chessboard::BOARD_SIZE - tmpBishopPos.first - 1) + tmpBishopPos.second) % 2)){
-                    // two bishops on same colour diagonal
-                    twoBishopDeadPos = true;
-                }
-                numBishopOrKnight++;
-            }
-        }
-    }
-    if(numBishopOrKnight == 1 || (numBishopOrKnight == 2 && twoBishopDeadPos) || numBishopOrKnight == 0){
-        score = 0;
-    }
-
-    //Avoid 50 move draw
-    if(board->fiftyMoveDrawCount >= 49){
-        score = 0;
-    }
-    return score;
+Move Computer::level4Move(Position* board){
+    return search->bestMove(*board);
 }
 
-int Computer::evaluateBoard(Chessboard *board){
-    int score = 0;
-    for(size_t i = 0; i < Chessboard::BOARD_SIZE; i++){
-        for(size_t j = 0; j < Chessboard::BOARD_SIZE; j++){
-            const Piece *piece = board->getState(i, j).first;
-            if(piece){
-                if(piece->getColour() == toupper(getId()[0])){
-                    // Same colour
-                    if(!board->isPieceBeingAttacked(j, i, piece->getColour())){
-                        score += pieceValues.at(toupper(piece->getName()));
-                    }
-                    else{
-                        score -= pieceValues.at(toupper(piece->getName()));
-                    }
-                }
-                else{
-                    // opposite colour
-                    if(!board->isPieceBeingAttacked(j, i, piece->getColour())){
-                        score -= pieceValues.at(toupper(piece->getName()));
-                    }
-                    else{
-                        score += pieceValues.at(toupper(piece->getName()));
-                    }
-                }
-            }
-        }
-    }
-    int eogScore = EndOfGameScore(board);
-    if(eogScore >= 0){
-        score = eogScore;
-    }
-    return score;
-}
-
-std::string Computer::level4Move(const Chessboard* board){
-    std::vector<std::string> validMoves;
-    board->getAllMoves(getId(), validMoves);
-    if(validMoves.empty()){
-        throw InternalErrorException{"Computer generated no moves"};
-    }
-    int maxScore = -1000000;
-    std::string bestMove = "";
-    for(std::string move : validMoves){
-        Chessboard copy = *board;
-        copy.executeMove(move, getId());
-        int score = evaluateBoard(&copy);
-        if(score > maxScore){
-            maxScore = score;
-            bestMove = move;
-        }
-    }
-    return bestMove;
+Move Computer::level5Move(Position* board){
+    Move move = search->bestMove(*board);
+    search->printStats(std::cout);
+    return move;
 }
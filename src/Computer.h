@@ -3,23 +3,32 @@
 
 #include "Player.h"
 #include <unordered_map>
-#include <vector>
+#include <memory>
+#include "Move.h"
+#include "Position.h"
+#include "Search.h"
 
 class Chessboard; // Forward declaration
 
 class Computer : public Player {
     int level;
-    std::string level1Move(const Chessboard* board);
-    std::string level2Move(const Chessboard* board);
-    std::string level3Move(const Chessboard* board);
-    std::string level4Move(const Chessboard* board);
-    static const std::unordered_map<char, int> pieceValues;
-    int evaluateBoard(Chessboard *board);
-    int EndOfGameScore(Chessboard* board);
+    Move level1Move(Position* board);
+    Move level2Move(Position* board);
+    Move level3Move(Position* board);
+    Move level4Move(Position* board);
+    Move level5Move(Position* board);
+    Colour colour();
+    // levels 4 and 5 only, kept between moves so the transposition table carries over
+    std::unique_ptr<Search> search;
+    friend class Bench;
     public:
         static const std::unordered_map<char, int> supportedLevels;
-        explicit Computer(std::string id, int level);
-        std::string getMove(const Chessboard* board);
+        // Material worth of each PieceType in pawns, the king is never traded
+        inline static constexpr int pieceValues[6] = {1, 3, 3, 5, 9, 0};
+        // Without any limit level 5 stops after DEFAULT_NODES nodes
+        inline static const uint64_t DEFAULT_NODES = 500000;
+        explicit Computer(std::string id, int level, SearchOptions options = SearchOptions{});
+        Move getMove(const Chessboard* board);
 };
 
 #endif
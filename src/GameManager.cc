@@ -3,54 +3,72 @@
 #include "./exceptions/InternalErrorException.h"
 #include "./exceptions/InvalidInputException.h"
 #include "Computer.h"
+#include <sstream>
+#include <chrono>
 
 GameManager::GameManager() : inSetupMode{false}, player1Score{0}, player2Score{0}, currentlyInGame{false} {}
 
-void GameManager::startGame(std::string player1Info, std::string player2Info){
-    if(inSetupMode){
-        throw InvalidInputException{"Can't start game while in setup mode."};
-    }
+std::unique_ptr<Player> GameManager::createPlayer(std::string info, std::string id, std::string which){
+    // e.g. "human", "computer3" or "computer5 depth=6 nodes=100000 hash=64 threads=4"
     const std::string computerPrefix = "computer";
-    std::string validIds[2];
-    chessboard.getValidPlayerIds(validIds);
-    
-    // white player
-    if(player1Info == "human")
-    {
-        player1 = std::make_unique<Human>(validIds[0]);
+    std::istringstream strm{info};
+    std::string type;
+    strm >> type;
+    if(type == "human"){
+        return std::make_unique<Human>(id);
     }
-    else if(player1Info.substr(0, computerPrefix.size()) == "computer"){
-        if(player1Info.length() == computerPrefix.size() + 1 && Computer::supportedLevels.contains(player1Info[computerPrefix.size()])){
-            player1 = std::make_unique<Computer>(validIds[0], Computer::supportedLevels.at(player1Info[computerPrefix.size()]));
-        }
-        else{
-            throw InvalidInputException{"Invalid computer level: player1"};
-        }
+    if(type.substr(0, computerPrefix.size()) != computerPrefix){
+        throw InvalidInputException{"Invalid input: " + which};
     }
-    else{
-        throw InvalidInputException{"Invalid input: player1"};
+    if(type.length() != computerPrefix.size() + 1 || !Computer::supportedLevels.contains(type[computerPrefix.size()])){
+        throw InvalidInputException{"Invalid computer level: " + which};
     }
+    int level = Computer::supportedLevels.at(type[computerPrefix.size()]);
 
-    // black player
-    if(player2Info == "human")
-    {
-        player2 = std::make_unique<Human>(validIds[1]);
-    }
-    else if(player2Info.substr(0, computerPrefix.size()) == "computer"){
-        if(player2Info.length() == computerPrefix.size() + 1 && Computer::supportedLevels.contains(player2Info[computerPrefix.size()])){
-            player2 = std::make_unique<Computer>(validIds[1], Computer::supportedLevels.at(player2Info[computerPrefix.size()]));
+    SearchOptions options;
+    std::string option;
+    while(strm >> option){
+        if(level != 5){
+            throw InvalidInputException{"Invalid input: only computer5 takes options"};
+        }
+        size_t equals = option.find('=');
+        std::string name = option.substr(0, equals);
+        std::istringstream valueStrm{equals == std::string::npos ? "" : option.substr(equals + 1)};
+        uint64_t value;
+        if(!(valueStrm >> value) || !valueStrm.eof()){
+            throw InvalidInputException{"Invalid computer option: " + option};
+        }
+        if(name == "depth"){
+            options.depth = value;
+        }
+        else if(name == "nodes"){
+            options.nodes = value;
+        }
+        else if(name == "hash" && value >= 1 && value <= Search::MAX_HASH){
+            options.hash = value;
+        }
+        else if(name == "threads" && value >= 1 && value <= Search::MAX_THREADS){
+            options.threads = value;
         }
         else{
-            // Move player into temp so when temp goes out of scope, gets destructed
-            std::unique_ptr<Player> temp = std::move(player1);
-            throw InvalidInputException{"Invalid computer level: player2"};
-        }    
+            throw InvalidInputException{"Invalid computer option: " + option};
+        }
     }
-    else{
-        // Move player into temp so when temp goes out of scope, gets destructed
-        std::unique_ptr<Player> temp = std::move(player1);
-        throw InvalidInputException{"Invalid input: player2"};
+    return std::make_unique<Computer>(id, level, options);
+}
+
+void GameManager::startGame(std::string player1Info, std::string player2Info){
+    if(inSetupMode){
+        throw InvalidInputException{"Can't start game while in setup mode."};
     }
+    std::string validIds[2];
+    chessboard.getValidPlayerIds(validIds);
+
+    // Both players are made before either is replaced, so an invalid one leaves nothing half set up
+    std::unique_ptr<Player> white = createPlayer(player1Info, validIds[0], "player1");
+    std::unique_ptr<Player> black = createPlayer(player2Info, validIds[1], "player2");
+    player1 = std::move(white);
+    player2 = std::move(black);
 
     currentPlayer = player1.get();
     currentlyInGame = true;
@@ -78,12 +96,12 @@ void GameManager::nextMove(std::string move){
     bool gameDone;
     if(computerPtr){
         // Query computer for move
-        std::string compMove = computerPtr->getMove(getBoard());
+        Move compMove = computerPtr->getMove(getBoard());
         gameDone = chessboard.executeMove(compMove, currentPlayer->getId());
     }
     else{
-        // Relay move directly to ChessBoard
-        gameDone = chessboard.executeMove(move, currentPlayer->getId());
+        // Parse the typed move and relay it to ChessBoard
+        gameDone = chessboard.executeMove(chessboard.parseMove(move), currentPlayer->getId());
     }
     if(gameDone){
         if(chessboard.getWinner() == player1->getId()){
@@ -101,6 +119,23 @@ void GameManager::nextMove(std::string move){
     currentPlayer = (currentPlayer == player1.get()) ? player2.get() : player1.get();
 }
 
+void GameManager::undoMove(){
+    if(!currentlyInGame){
+        throw InvalidInputException{"No game currently running!"};
+    }
+    chessboard.undoMove();
+    // the player whose move was taken back is to move again
+    currentPlayer = (currentPlayer == player1.get()) ? player2.get() : player1.get();
+}
+
+void GameManager::redoMove(){
+    if(!currentlyInGame){
+        throw InvalidInputException{"No game currently running!"};
+    }
+    chessboard.redoMove();
+    currentPlayer = (currentPlayer == player1.get()) ? player2.get() : player1.get();
+}
+
 void GameManager::printSeriesScore(std::ostream &o) const{
     o << "Final Score: " << std::endl;
     o << (player1 ? player1->getId() : "White") << ": " << (player1Score / 2) << (player1Score % 2 ? ".5" : "") << std::endl 
@@ -131,6 +166,9 @@ void GameManager::runSetupCommand(std::string cmd){
         else if(cmd[0] == '='){
             chessboard.setColour(cmd.substr(1));
         }
+        else if(cmd.substr(0, 3) == "fen"){
+            chessboard.loadFen(cmd.substr(3));
+        }
         else if (cmd == "done"){
             // stay in setup mode if board is not valid
             if(!chessboard.validChessboard()){
@@ -150,6 +188,31 @@ void GameManager::runSetupCommand(std::string cmd){
     }
 }
 
+void GameManager::runPerft(std::string args, std::ostream &out){
+    // Also allowed in setup mode, so any position loaded with fen can be counted
+    std::istringstream strm{args};
+    int depth;
+    std::string option;
+    if(!(strm >> depth) || depth < 0){
+        throw InvalidInputException{"Invalid input: perft depth"};
+    }
+    bool divide = (strm >> option) && option == "divide";
+    // a setup board is counted before done has checked it, more pieces than a game allows could overflow a move list
+    if(!chessboard.getPosition().hasReachableMaterial()){
+        throw InvalidInputException{"Invalid input: too many pieces to count"};
+    }
+
+    // Counted on a copy of the position so the observers never see the search
+    Position position = chessboard.getPosition();
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = position.perft(depth, divide ? &out : nullptr);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    out << "Nodes: " << nodes << std::endl;
+    out << "Time: " << seconds << "s" << std::endl;
+    out << "Nodes/second: " << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0) << std::endl;
+}
+
 void GameManager::attachObserver(std::unique_ptr<Observer> o){
     chessboard.attach(std::move(o));
 }
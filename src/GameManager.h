@@ -15,14 +15,18 @@ class GameManager{
     Player* currentPlayer;
     bool currentlyInGame;
     Chessboard chessboard;
+    static std::unique_ptr<Player> createPlayer(std::string info, std::string id, std::string which);
     public:
         GameManager();
         void startGame(std::string player1Info, std::string player2Info);
         void forfeitGame();
         void nextMove(std::string move);
+        void undoMove();
+        void redoMove();
         void printSeriesScore(std::ostream &) const;
         void setSetupMode(bool);
         void runSetupCommand(std::string);
+        void runPerft(std::string args, std::ostream &out);
         void attachObserver(std::unique_ptr<Observer> o);
         void detachObserver(std::unique_ptr<Observer> o);
         const Chessboard* getBoard() const; 
@@ -51,24 +51,21 @@ GraphicsObserver::GraphicsObserver(const Chessboard* board, const Theme& theme)
 }
 
 void GraphicsObserver::notify() {
-    for (size_t row = 0; row < Chessboard::BOARD_SIZE; ++row) {
-        for (size_t col = 0; col < Chessboard::BOARD_SIZE; ++col) {
-            std::pair<const Piece*, const Piece*> pieces = subject->getState(row, col);
-            const Piece* oldPiece = pieces.second;
-            const Piece* piece = pieces.first;
+    // Only the squares the board reports as changed are redrawn
+    Bitboard changed = subject->getChangedSquares();
+    while (changed) {
+        int square = popLsb(changed);
+        size_t row = rowOf(square);
+        size_t col = colOf(square);
+        Piece piece = subject->getState(row, col);
 
-            int squareColor = (((Chessboard::BOARD_SIZE - row - 1) + col) % 2 == 0) ? currentTheme.lightSquareColour : currentTheme.darkSquareColour;
+        int squareColor = (((Chessboard::BOARD_SIZE - row - 1) + col) % 2 == 0) ? currentTheme.lightSquareColour : currentTheme.darkSquareColour;
 
-            if(oldPiece && !piece){
-                int squareColor = (((Chessboard::BOARD_SIZE - row - 1) + col) % 2 == 0) ? currentTheme.lightSquareColour : currentTheme.darkSquareColour;
-                window->fillRectangle(col * GRID_SIZE, (Chessboard::BOARD_SIZE - row - 1) * GRID_SIZE, GRID_SIZE, GRID_SIZE, squareColor);
-            }
-            else if(!oldPiece && piece){
-                window->drawPiece(col*GRID_SIZE, (Chessboard::BOARD_SIZE - row - 1)*GRID_SIZE, squareColor, getPieceImgArray(piece->getName()));
-            }
-            else if(oldPiece && piece && *oldPiece != *piece){
-                window->drawPiece(col*GRID_SIZE, (Chessboard::BOARD_SIZE - row - 1)*GRID_SIZE, squareColor, getPieceImgArray(piece->getName()));
-            }
+        if(piece){
+            window->drawPiece(col*GRID_SIZE, (Chessboard::BOARD_SIZE - row - 1)*GRID_SIZE, squareColor, getPieceImgArray(piece.getName()));
+        }
+        else{
+            window->fillRectangle(col * GRID_SIZE, (Chessboard::BOARD_SIZE - row - 1) * GRID_SIZE, GRID_SIZE, GRID_SIZE, squareColor);
         }
     }
 }
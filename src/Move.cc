@@ -0,0 +1,10 @@
+#include "Move.h"
+
+std::string Move::toString() const{
+    std::string move = std::string{static_cast<char>(colOf(from()) + 'a'), static_cast<char>(rowOf(from()) + '1'), ' ',
+        static_cast<char>(colOf(to()) + 'a'), static_cast<char>(rowOf(to()) + '1')};
+    if(type() == PROMOTION){
+        move += std::string{' ', "NBRQ"[promotion() - KNIGHT]};
+    }
+    return move;
+}
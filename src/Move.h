@@ -0,0 +1,67 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include <cstdint>
+#include <string>
+#include "Bitboard.h"
+
+// A move packed into 16 bits: from square (bits 0-5), to square (bits 6-11),
+// promotion piece type (bits 12-13, knight to queen) and the move type (bits 14-15)
+class Move {
+    uint16_t data;
+    public:
+        enum Type { NORMAL, PROMOTION, EN_PASSANT, CASTLING };
+        // Left uninitialised so arrays of moves are free to create, Move{} is the all zero move
+        Move() = default;
+        Move(int from, int to, Type type = NORMAL, PieceType promotion = KNIGHT)
+            : data{static_cast<uint16_t>(from | (to << 6) | ((promotion - KNIGHT) << 12) | (type << 14))} {}
+        int from() const { return data & 0x3F; }
+        int to() const { return (data >> 6) & 0x3F; }
+        Type type() const { return static_cast<Type>(data >> 14); }
+        PieceType promotion() const { return static_cast<PieceType>(((data >> 12) & 0x3) + KNIGHT); }
+        // The packed bits, for tables that store moves compactly
+        uint16_t raw() const { return data; }
+        static Move fromRaw(uint16_t data){
+            Move move;
+            move.data = data;
+            return move;
+        }
+        bool operator==(const Move &other) const = default;
+        // e.g. "e2 e4" or "e7 e8 Q", the same format the move command reads
+        std::string toString() const;
+};
+
+static_assert(sizeof(Move) == 2, "Move must stay packed in 16 bits");
+
+// Why a move is or is not legal, returned by Position::tryMove instead of throwing
+enum MoveStatus {
+    LEGAL,
+    NO_PIECE_AT_START,
+    NOT_OWN_PIECE,
+    ILLEGAL_PIECE_MOVE,
+    KING_NOT_ON_HOME_SQUARE,
+    NO_CASTLING_ROOK,
+    CASTLING_RIGHTS_LOST,
+    CASTLING_BLOCKED,
+    CASTLING_OUT_OF_CHECK,
+    CASTLING_THROUGH_CHECK,
+    NO_EN_PASSANT,
+    PAWN_ALREADY_MOVED,
+    PAWN_BLOCKED,
+    INVALID_PROMOTION,
+    CAPTURES_OWN_PIECE,
+    CAPTURES_KING,
+    LEAVES_KING_IN_CHECK
+};
+
+// Everything makeMove overwrites that unmakeMove cannot work out from the move itself
+struct Undo {
+    int captured;
+    int castlingRights;
+    int enPassantSquare;
+    int fiftyMoveDrawCount;
+    Bitboard attackMaps[2];
+    uint64_t key;
+};
+
+#endif
@@ -0,0 +1,112 @@
+#include "MoveGenerator.h"
+#include "Computer.h"
+
+MoveGenerator::MoveGenerator(const Position &position) : MoveGenerator{position, false, false} {}
+
+MoveGenerator::MoveGenerator(const Position &position, bool orderCaptures, bool capturesOnly) : position{position},
+    us{position.getSideToMove()}, step{GENERATE_CAPTURES}, stage{CAPTURES}, index{0}, hashMove{}, killers{}, history{nullptr},
+    orderCaptures{orderCaptures}, capturesOnly{capturesOnly} {}
+
+MoveGenerator::MoveGenerator(const Position &position, Move hashMove, const Move (&killers)[2], const HistoryTable &history)
+    : position{position}, us{position.getSideToMove()}, step{HASH_MOVE}, stage{CAPTURES}, index{0}, hashMove{hashMove},
+    killers{killers[0], killers[1] != killers[0] ? killers[1] : Move{}}, history{&history}, orderCaptures{true}, capturesOnly{false} {}
+
+MoveGenerator MoveGenerator::capturesOf(const Position &position){
+    return MoveGenerator{position, true, true};
+}
+
+int MoveGenerator::captureGain(const Position &position, Move move){
+    Piece victim = position.pieceAt(move.to());
+    int gain = move.type() == Move::EN_PASSANT ? Computer::pieceValues[PAWN] : victim ? Computer::pieceValues[victim.type()] : 0;
+    if(move.type() == Move::PROMOTION){
+        gain += Computer::pieceValues[move.promotion()] - Computer::pieceValues[PAWN];
+    }
+    return gain;
+}
+
+// Most valuable victim first, and of those the capture by the least valuable piece. A promotion
+// counts the piece it gains, so a quiet queen promotion still comes before most captures
+static int captureScore(const Position &position, Move move){
+    return 16 * MoveGenerator::captureGain(position, move) - Computer::pieceValues[position.pieceAt(move.from()).type()];
+}
+
+bool MoveGenerator::isQuiet(Move move) const{
+    return (move.type() == Move::NORMAL || move.type() == Move::CASTLING) && !position.pieceAt(move.to());
+}
+
+bool MoveGenerator::isPlayable(Move move) const{
+    Piece piece = position.pieceAt(move.from());
+    return move != Move{} && piece && piece.colour() == us && position.isLegal(move);
+}
+
+bool MoveGenerator::next(Move &move){
+    switch(step){
+        case HASH_MOVE:
+            step = GENERATE_CAPTURES;
+            if(isPlayable(hashMove)){
+                stage = isQuiet(hashMove) ? QUIETS : CAPTURES;
+                move = hashMove;
+                return true;
+            }
+            hashMove = Move{};
+            [[fallthrough]];
+        case GENERATE_CAPTURES:
+            moves = position.getMoves(us, CAPTURES);
+            if(orderCaptures){
+                for(size_t i = 0; i < moves.size(); i++){
+                    moves.score(i) = captureScore(position, moves[i]);
+                }
+                moves.sortByScore();
+            }
+            index = 0;
+            step = CAPTURE_MOVES;
+            [[fallthrough]];
+        case CAPTURE_MOVES:
+            stage = CAPTURES;
+            while(index < moves.size()){
+                move = moves[index++];
+                if(move != hashMove) return true;
+            }
+            if(capturesOnly){
+                step = DONE;
+                return false;
+            }
+            index = 0;
+            step = KILLER_MOVES;
+            [[fallthrough]];
+        case KILLER_MOVES:
+            stage = QUIETS;
+            // killers come from other positions at the same ply, so they may not even be legal here
+            while(history && index < 2){
+                move = killers[index++];
+                if(move != hashMove && isQuiet(move) && isPlayable(move)) return true;
+            }
+            step = GENERATE_QUIETS;
+            [[fallthrough]];
+        case GENERATE_QUIETS:
+            moves = position.getMoves(us, QUIETS);
+            if(history){
+                for(size_t i = 0; i < moves.size(); i++){
+                    moves.score(i) = (*history)[moves[i].from()][moves[i].to()];
+                }
+                moves.sortByScore();
+            }
+            index = 0;
+            step = QUIET_MOVES;
+            [[fallthrough]];
+        case QUIET_MOVES:
+            while(index < moves.size()){
+                move = moves[index++];
+                if(move != hashMove && move != killers[0] && move != killers[1]) return true;
+            }
+            step = DONE;
+            [[fallthrough]];
+        case DONE:
+            break;
+    }
+    return false;
+}
+
+MoveStage MoveGenerator::currentStage() const{
+    return stage;
+}
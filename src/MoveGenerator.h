@@ -0,0 +1,48 @@
+#ifndef MOVEGENERATOR_H
+#define MOVEGENERATOR_H
+
+#include "Position.h"
+#include "MoveList.h"
+
+// Score of each quiet move by [from][to] for one side, raised by the search whenever the move causes a cutoff
+using HistoryTable = int[64][64];
+
+// Hands out the legal moves of a position one at a time, captures and promotions first and
+// quiet moves after. A stage is only generated once the one before it runs out, so a caller
+// that stops early never pays for the rest. The position must be the same on every call
+class MoveGenerator {
+    enum Step { HASH_MOVE, GENERATE_CAPTURES, CAPTURE_MOVES, KILLER_MOVES, GENERATE_QUIETS, QUIET_MOVES, DONE };
+    const Position &position;
+    Colour us;
+    Step step;
+    MoveStage stage;
+    MoveList moves;
+    size_t index;
+    Move hashMove;
+    Move killers[2];
+    // null unless quiet moves are ordered
+    const HistoryTable *history;
+    bool orderCaptures;
+    bool capturesOnly;
+    MoveGenerator(const Position &position, bool orderCaptures, bool capturesOnly);
+    bool isQuiet(Move move) const;
+    // the hash move and killers only get through once they pass the same checks a typed in move would
+    bool isPlayable(Move move) const;
+    public:
+        // Moves in the order they are generated
+        explicit MoveGenerator(const Position &position);
+        // Ordered for a search: the hash move, captures by most valuable victim then least valuable
+        // attacker, the killer moves, then the remaining quiet moves by history score. The hash move
+        // and killers are checked for legality before they are handed out, Move{} stands for none
+        MoveGenerator(const Position &position, Move hashMove, const Move (&killers)[2], const HistoryTable &history);
+        // Only the captures and promotions, in the same order, for searching exchanges to the end
+        static MoveGenerator capturesOf(const Position &position);
+        // Material the move wins in pawns, the piece taken plus what a promotion adds
+        static int captureGain(const Position &position, Move move);
+        // The next legal move, false once every move has been handed out
+        bool next(Move &move);
+        // CAPTURES or QUIETS, the stage the last move handed out belongs to
+        MoveStage currentStage() const;
+};
+
+#endif
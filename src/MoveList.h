@@ -0,0 +1,60 @@
+#ifndef MOVELIST_H
+#define MOVELIST_H
+
+#include <cstddef>
+#include <type_traits>
+#include "Move.h"
+#include "./exceptions/InternalErrorException.h"
+
+// Moves stored inline with an ordering score each, so building a list never touches the heap.
+// No position with material a game can reach has more than 218 moves, the capacity leaves room to spare.
+// Setup refuses any other material (Position::hasReachableMaterial), so overflowing is an internal error
+class MoveList {
+    public:
+        inline static const size_t CAPACITY = 256;
+        MoveList() : count{0} {}
+        void push_back(Move move, int score = 0){
+            if(count == CAPACITY){
+                throw InternalErrorException{"Internal Error: too many moves for a move list"};
+            }
+            moves[count] = move;
+            scores[count] = score;
+            count++;
+        }
+        void clear(){ count = 0; }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        Move operator[](size_t i) const { return moves[i]; }
+        int& score(size_t i){ return scores[i]; }
+        int score(size_t i) const { return scores[i]; }
+        const Move* begin() const { return moves; }
+        const Move* end() const { return moves + count; }
+        bool contains(Move move) const {
+            for(size_t i = 0; i < count; i++){
+                if(moves[i] == move) return true;
+            }
+            return false;
+        }
+        // Highest score first, moves with equal scores keep their generated order
+        void sortByScore(){
+            for(size_t i = 1; i < count; i++){
+                Move move = moves[i];
+                int score = scores[i];
+                size_t j = i;
+                for(; j > 0 && scores[j - 1] < score; j--){
+                    moves[j] = moves[j - 1];
+                    scores[j] = scores[j - 1];
+                }
+                moves[j] = move;
+                scores[j] = score;
+            }
+        }
+    private:
+        Move moves[CAPACITY];
+        int scores[CAPACITY];
+        size_t count;
+};
+
+static_assert(std::is_trivially_default_constructible_v<Move>, "Move must stay trivial so an empty MoveList costs nothing to create");
+
+#endif
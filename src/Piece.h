@@ -1,19 +1,29 @@
 #ifndef PIECE_H
 #define PIECE_H
 
-#include <string>
-#include <map>
+#include <cstdint>
+#include <type_traits>
+#include "Bitboard.h"
 
+// A piece packed into one byte: its pieceIndex plus one, zero for an empty square.
+// Pieces are plain values, how they move lives in the attack tables in Bitboard.h
 class Piece{
-    char name;
-    char colour;
+    uint8_t code;
     public:
-        Piece(char p, char c);
-        virtual bool isValidMove(int row, int col) const = 0;
-        virtual char getName() const;
-        virtual char getColour() const;
-        virtual ~Piece() = default;
-        virtual bool operator==(const Piece &other) const;
+        constexpr Piece() : code{0} {}
+        // NO_PIECE gives the empty square
+        constexpr explicit Piece(int index) : code{static_cast<uint8_t>(index + 1)} {}
+        constexpr int index() const { return code - 1; }
+        constexpr explicit operator bool() const { return code != 0; }
+        Colour colour() const { return colourOf(index()); }
+        PieceType type() const { return typeOf(index()); }
+        // Letter used on the text board, upper case for white
+        char getName() const;
+        // 'W' or 'B'
+        char getColour() const;
+        bool operator==(const Piece &other) const = default;
 };
 
+static_assert(sizeof(Piece) == 1 && std::is_trivially_copyable_v<Piece>, "Piece must stay a one byte value");
+
 #endif
@@ -0,0 +1,827 @@
+#include "Position.h"
+#include "Zobrist.h"
+
+#include "./exceptions/InternalErrorException.h"
+#include "./exceptions/InvalidInputException.h"
+
+#include <sstream>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+Position::Position() : pieceBoards{}, occupancy{}, attackMaps{}, squares{}, castlingRights{0}, enPassantSquare{NO_SQUARE}, sideToMove{WHITE}, fiftyMoveDrawCount{0}, key{0} {
+    resetKey();
+}
+
+void Position::clear(Colour side) {
+    *this = Position{};
+    sideToMove = side;
+    resetKey();
+}
+
+void Position::setPiece(int square, int piece) {
+    liftPiece(square);
+    if(piece != NO_PIECE){
+        placePiece(piece, square);
+    }
+    // Rights given by a FEN stay, except those whose king or rook square was just replaced
+    castlingRights &= ~castlingRightsLost(square);
+    checkEnPassantSquare();
+    updateAttackMaps();
+    resetKey();
+}
+
+void Position::setSideToMove(Colour side) {
+    sideToMove = side;
+    checkEnPassantSquare();
+    resetKey();
+}
+
+void Position::loadFen(std::string fen){
+    // e.g. "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1", the move counters are optional
+    std::istringstream strm{fen};
+    std::string placement, side, castling, enPassant;
+    int halfMoves = 0;
+    if(!(strm >> placement >> side >> castling >> enPassant) || (side != "w" && side != "b")){
+        throw InvalidInputException{"Invalid input: FEN"};
+    }
+    strm >> halfMoves;
+
+    // Ranks are listed from 8 down to 1, the position is only replaced once all of them parse
+    const std::string pieceLetters = "PNBRQKpnbrqk";
+    std::vector<std::pair<int, int>> pieces;
+    int row = 7, col = 0;
+    for(char c : placement){
+        if(c == '/' && col == 8 && row > 0){
+            row--;
+            col = 0;
+        }
+        else if(c >= '1' && c <= '8' && col + (c - '0') <= 8){
+            col += c - '0';
+        }
+        else if(pieceLetters.find(c) != std::string::npos && col < 8){
+            pieces.emplace_back(pieceLetters.find(c), squareOf(row, col++));
+        }
+        else{
+            throw InvalidInputException{"Invalid input: FEN piece placement"};
+        }
+    }
+    if(row != 0 || col != 8){
+        throw InvalidInputException{"Invalid input: FEN piece placement"};
+    }
+
+    Colour us = side == "w" ? WHITE : BLACK;
+    *this = Position{};
+    sideToMove = us;
+    for(const auto &[piece, square] : pieces){
+        placePiece(piece, square);
+    }
+
+    // Rights are only kept for a king and rook still on their home squares
+    resetCastlingRights();
+    int rights = 0;
+    for(char c : castling){
+        if(c == 'K') rights |= WHITE_KINGSIDE;
+        if(c == 'Q') rights |= WHITE_QUEENSIDE;
+        if(c == 'k') rights |= BLACK_KINGSIDE;
+        if(c == 'q') rights |= BLACK_QUEENSIDE;
+    }
+    castlingRights &= rights;
+
+    if(enPassant.size() == 2 && enPassant[0] >= 'a' && enPassant[0] <= 'h' && enPassant[1] == (us == WHITE ? '6' : '3')){
+        enPassantSquare = squareOf(enPassant[1] - '1', enPassant[0] - 'a');
+        checkEnPassantSquare();
+    }
+    fiftyMoveDrawCount = halfMoves;
+    updateAttackMaps();
+    resetKey();
+}
+
+Piece Position::pieceAt(int square) const {
+    return squares[square];
+}
+
+Bitboard Position::pieces(Colour colour, PieceType type) const {
+    return pieceBoards[pieceIndex(colour, type)];
+}
+
+Colour Position::getSideToMove() const {
+    return sideToMove;
+}
+
+int Position::getEnPassantSquare() const {
+    return enPassantSquare;
+}
+
+int Position::getFiftyMoveDrawCount() const {
+    return fiftyMoveDrawCount;
+}
+
+bool Position::isSquareAttacked(int square, Colour by) const {
+    return attackMaps[by] & squareBB(square);
+}
+
+Bitboard Position::getAttackMap(Colour by) const {
+    return attackMaps[by];
+}
+
+bool Position::inCheck(Colour colour) const {
+    Bitboard king = pieceBoards[pieceIndex(colour, KING)];
+
+    if(!king) {
+        throw InternalErrorException{"Internal Error: King not found"};
+    }
+
+    return attackMaps[opposite(colour)] & king;
+}
+
+bool Position::isDeadPosition() const {
+    // Only kings and at most one minor piece, or two bishops on the same colour squares
+    const Bitboard lightSquares = 0x55AA55AA55AA55AAULL;
+    Bitboard bishops = pieceBoards[pieceIndex(WHITE, BISHOP)] | pieceBoards[pieceIndex(BLACK, BISHOP)];
+    Bitboard knights = pieceBoards[pieceIndex(WHITE, KNIGHT)] | pieceBoards[pieceIndex(BLACK, KNIGHT)];
+    Bitboard kings = pieceBoards[pieceIndex(WHITE, KING)] | pieceBoards[pieceIndex(BLACK, KING)];
+    if((occupancy[WHITE] | occupancy[BLACK]) != (bishops | knights | kings)){
+        // If we have some other piece then we ignore
+        return false;
+    }
+    int numBishopOrKnight = popCount(bishops | knights);
+    bool twoBishopDeadPos = !knights && ((bishops & lightSquares) == 0 || (bishops & ~lightSquares) == 0);
+    return numBishopOrKnight <= 1 || (numBishopOrKnight == 2 && twoBishopDeadPos);
+}
+
+bool Position::hasReachableMaterial() const {
+    // Every piece past the starting set has to be a promoted pawn, so it comes out of the eight pawns
+    for(Colour colour : {WHITE, BLACK}){
+        int pawns = popCount(pieceBoards[pieceIndex(colour, PAWN)]);
+        int promoted = std::max(0, popCount(pieceBoards[pieceIndex(colour, QUEEN)]) - 1)
+            + std::max(0, popCount(pieceBoards[pieceIndex(colour, ROOK)]) - 2)
+            + std::max(0, popCount(pieceBoards[pieceIndex(colour, BISHOP)]) - 2)
+            + std::max(0, popCount(pieceBoards[pieceIndex(colour, KNIGHT)]) - 2);
+        if(popCount(occupancy[colour]) > 16 || pawns + promoted > 8){
+            return false;
+        }
+    }
+    return true;
+}
+
+MoveStatus Position::tryMove(Move move, Colour player) const{
+    // validate the move
+    // check if piece exists at starting position
+    int piece = pieceOn(move.from());
+    if(piece == NO_PIECE) {
+        return NO_PIECE_AT_START;
+    }
+
+    // check if player is moving one of their pieces
+    if(colourOf(piece) != player) {
+        return NOT_OWN_PIECE;
+    }
+    return player == WHITE ? tryMove<WHITE>(move) : tryMove<BLACK>(move);
+}
+
+template<Colour Us> MoveStatus Position::tryMove(Move move) const{
+    constexpr Colour Them = opposite(Us);
+    int from = move.from();
+    int to = move.to();
+    int piece = pieceOn(from);
+    PieceType type = typeOf(piece);
+
+    // rows counted towards the enemy, so pawns of both sides move up
+    int relativeMoveY = relativeRow<Us>(rowOf(to)) - relativeRow<Us>(rowOf(from));
+    int relativeMoveX = colOf(to) - colOf(from);
+
+    Bitboard occupied = occupancy[WHITE] | occupancy[BLACK];
+    int captured = pieceOn(to);
+
+    // the flags have to fit the piece and squares, makeMove acts on them without looking again
+    if(move.type() != Move::PROMOTION && move.promotion() != KNIGHT) {
+        return INVALID_PROMOTION;
+    }
+    if(move.type() == Move::PROMOTION && type != PAWN) {
+        return INVALID_PROMOTION;
+    }
+    if(move.type() == Move::EN_PASSANT && (type != PAWN || to != enPassantSquare || abs(relativeMoveX) != 1 || relativeMoveY != 1)) {
+        return NO_EN_PASSANT;
+    }
+
+    if(move.type() == Move::CASTLING) { // castle conditions
+        if(type != KING || abs(relativeMoveX) != 2 || relativeMoveY != 0){
+            return ILLEGAL_PIECE_MOVE;
+        }
+        // If king is not in right spot we can immediately say no castle
+        constexpr int homeRow = relativeRow<Us>(0);
+        if(from != squareOf(homeRow, 4)){
+            return KING_NOT_ON_HOME_SQUARE;
+        }
+
+        constexpr int kingside = Us == WHITE ? WHITE_KINGSIDE : BLACK_KINGSIDE;
+        constexpr int queenside = Us == WHITE ? WHITE_QUEENSIDE : BLACK_QUEENSIDE;
+        int right = relativeMoveX == 2 ? kingside : queenside;
+        int rookSquare = squareOf(homeRow, relativeMoveX == 2 ? 7 : 0);
+        if(pieceOn(rookSquare) != pieceIndex(Us, ROOK)){
+            return NO_CASTLING_ROOK;
+        }
+        if(!(castlingRights & right)) {
+            return CASTLING_RIGHTS_LOST;
+        }
+
+        // every square strictly between king and rook must be empty
+        if(occupied & betweenSquares(from, rookSquare)){
+            return CASTLING_BLOCKED;
+        }
+
+        if(attackMaps[Them] & squareBB(from)) {
+            return CASTLING_OUT_OF_CHECK;
+        }
+        // the king may not pass over an attacked square
+        if(attackMaps[Them] & squareBB((from + to) / 2)) {
+            return CASTLING_THROUGH_CHECK;
+        }
+    }
+    else if(type == PAWN) {
+        // pawn trying to capture/en passant
+        if(abs(relativeMoveX) == 1 && relativeMoveY == 1) {
+            // en passant
+            if(captured == NO_PIECE && (to != enPassantSquare || move.type() != Move::EN_PASSANT)) {
+                return NO_EN_PASSANT;
+            }
+        }
+        // if its the pawns first move and it moves 2
+        else if(relativeMoveY == 2 && relativeMoveX == 0) {
+            // can only move forward 2 on first turn
+            if (rowOf(from) != relativeRow<Us>(1)) {
+                return PAWN_ALREADY_MOVED;
+            }
+            // also cannot capture or jump
+            if(occupied & (squareBB(to) | squareBB(from + pawnPush<Us>))) {
+                return PAWN_BLOCKED;
+            }
+        }
+        // normal pawn move (can't capture)
+        else if(relativeMoveY == 1 && relativeMoveX == 0) {
+            if(captured != NO_PIECE) {
+                return PAWN_BLOCKED;
+            }
+        }
+        else {
+            return ILLEGAL_PIECE_MOVE;
+        }
+
+        if((rowOf(to) == relativeRow<Us>(7)) != (move.type() == Move::PROMOTION)) {
+            return INVALID_PROMOTION;
+        }
+    }
+    // the attack mask of a slider already stops at the first blocker, so this also checks the path
+    else if(!(attacksFrom(piece, from, occupied) & squareBB(to))) {
+        return ILLEGAL_PIECE_MOVE;
+    }
+
+    // if a piece exists at target, ensure that piece is opposite colour (capture case)
+    if(captured != NO_PIECE) {
+        if(colourOf(captured) == Us) {
+            return CAPTURES_OWN_PIECE;
+        }
+        // ensure we are not capturing a king
+        if(typeOf(captured) == KING){
+            return CAPTURES_KING;
+        }
+    }
+
+    if (!keepsKingSafe<Us>(move)) {
+        return LEAVES_KING_IN_CHECK;
+    }
+    return LEGAL;
+}
+
+bool Position::isLegal(Move move) const{
+    int piece = pieceOn(move.from());
+    return piece != NO_PIECE && tryMove(move, colourOf(piece)) == LEGAL;
+}
+
+bool Position::givesCheck(Move move) const{
+    return colourOf(pieceOn(move.from())) == WHITE ? givesCheck<WHITE>(move) : givesCheck<BLACK>(move);
+}
+
+template<Colour Us> bool Position::givesCheck(Move move) const{
+    int from = move.from();
+    int to = move.to();
+    int king = lsb(pieceBoards[pieceIndex(opposite(Us), KING)]);
+    int moved = move.type() == Move::PROMOTION ? pieceIndex(Us, move.promotion()) : pieceOn(from);
+    // the board as it will be after the move, which may open lines as well as close them
+    Bitboard occupied = ((occupancy[WHITE] | occupancy[BLACK]) ^ squareBB(from)) | squareBB(to);
+    Bitboard left = squareBB(from);
+    if(move.type() == Move::EN_PASSANT){
+        occupied ^= squareBB(to - pawnPush<Us>);
+    }
+    else if(move.type() == Move::CASTLING){
+        // only the rook can give check, from the square it lands on
+        int rookFrom = squareOf(rowOf(from), to > from ? 7 : 0);
+        int rookTo = squareOf(rowOf(from), to > from ? 5 : 3);
+        occupied ^= squareBB(rookFrom) | squareBB(rookTo);
+        left |= squareBB(rookFrom);
+        if(rookAttacks(rookTo, occupied) & squareBB(king)){
+            return true;
+        }
+    }
+
+    // direct check from the piece on its new square
+    if(attacksFrom(moved, to, occupied) & squareBB(king)){
+        return true;
+    }
+    // discovered check by a slider the move has uncovered
+    Bitboard queens = pieceBoards[pieceIndex(Us, QUEEN)];
+    Bitboard sliders = (bishopAttacks(king, occupied) & (pieceBoards[pieceIndex(Us, BISHOP)] | queens))
+        | (rookAttacks(king, occupied) & (pieceBoards[pieceIndex(Us, ROOK)] | queens));
+    return sliders & ~left;
+}
+
+MoveList Position::getAllMoves(Colour us) const{
+    return getMoves(us, ALL_MOVES);
+}
+
+MoveList Position::getMoves(Colour us, MoveStage stage) const{
+    MoveList validMoves;
+    switch(stage){
+        case CAPTURES: us == WHITE ? generateMoves<WHITE, CAPTURES>(validMoves) : generateMoves<BLACK, CAPTURES>(validMoves); break;
+        case QUIETS: us == WHITE ? generateMoves<WHITE, QUIETS>(validMoves) : generateMoves<BLACK, QUIETS>(validMoves); break;
+        case ALL_MOVES: us == WHITE ? generateMoves<WHITE, ALL_MOVES>(validMoves) : generateMoves<BLACK, ALL_MOVES>(validMoves); break;
+    }
+    return validMoves;
+}
+
+// Adds a move for every pawn target, each pawn standing Step squares behind its target. A pinned
+// pawn may only move along the line through its king
+template<Colour Us, int Step> static void addPawnMoves(Bitboard targets, Bitboard pinned, int king, MoveList &validMoves){
+    while(targets){
+        int to = popLsb(targets);
+        int from = to - Step;
+        if((pinned & squareBB(from)) && !(lineThrough(king, from) & squareBB(to))){
+            continue;
+        }
+        if(rowOf(to) == relativeRow<Us>(7)){
+            // Pawn promotion, one move per promotion piece
+            validMoves.push_back(Move{from, to, Move::PROMOTION, QUEEN});
+            validMoves.push_back(Move{from, to, Move::PROMOTION, KNIGHT});
+            validMoves.push_back(Move{from, to, Move::PROMOTION, ROOK});
+            validMoves.push_back(Move{from, to, Move::PROMOTION, BISHOP});
+        }
+        else{
+            validMoves.push_back(Move{from, to});
+        }
+    }
+}
+
+template<Colour Us, MoveStage Stage> void Position::generateMoves(MoveList &validMoves) const{
+    constexpr Colour Them = opposite(Us);
+    constexpr int Up = pawnPush<Us>;
+    constexpr Bitboard promotionRank = relativeRank<Us>(7);
+    Bitboard occupied = occupancy[WHITE] | occupancy[BLACK];
+    Bitboard kingBB = pieceBoards[pieceIndex(Us, KING)];
+    if(!kingBB){
+        throw InternalErrorException{"Internal Error: King not found"};
+    }
+    int king = lsb(kingBB);
+    // the squares a piece move may land on in this stage
+    Bitboard stageTargets = Stage == CAPTURES ? occupancy[Them] : Stage == QUIETS ? ~occupied : ~occupancy[Us];
+
+    // Pins and checks are worked out once, after that every emitted move is legal without trying it
+    Bitboard checkers = (attackMaps[Them] & kingBB) ? attackersTo(king, occupied) & occupancy[Them] : 0;
+    // sliders see through the king, so it cannot step back along a checking ray. Without
+    // a check no ray reaches the king and the maintained attack map is already exact.
+    Bitboard danger = checkers ? attackedSquares<Them>(occupied ^ kingBB) : attackMaps[Them];
+
+    Bitboard kingTargets = kingAttacks(king) & stageTargets & ~danger;
+    while(kingTargets){
+        validMoves.push_back(Move{king, popLsb(kingTargets)});
+    }
+    if(popCount(checkers) > 1){
+        // double check, only the king can move
+        return;
+    }
+
+    // with a single check every other move has to capture the checker or block the ray
+    Bitboard checkMask = checkers ? checkers | betweenSquares(king, lsb(checkers)) : ~Bitboard{0};
+    Bitboard pinned = pinnedPieces<Us>();
+
+    if(Stage != CAPTURES && !checkers){
+        constexpr int rights[2] = {Us == WHITE ? WHITE_KINGSIDE : BLACK_KINGSIDE, Us == WHITE ? WHITE_QUEENSIDE : BLACK_QUEENSIDE};
+        for(int side = 0; side < 2; side++){
+            // castling rights imply the king and rook are still on their home squares
+            int rook = side == 0 ? king + 3 : king - 4;
+            int to = side == 0 ? king + 2 : king - 2;
+            Bitboard kingPath = betweenSquares(king, to) | squareBB(to);
+            if((castlingRights & rights[side]) && !(betweenSquares(king, rook) & occupied) && !(kingPath & danger)){
+                validMoves.push_back(Move{king, to, Move::CASTLING});
+            }
+        }
+    }
+
+    Bitboard pawns = pieceBoards[pieceIndex(Us, PAWN)];
+    Bitboard pieces = occupancy[Us] & ~kingBB & ~pawns;
+    while(pieces){
+        int from = popLsb(pieces);
+        Bitboard targets = attacksFrom(pieceOn(from), from, occupied) & checkMask & stageTargets;
+        if(pinned & squareBB(from)){
+            // a pinned piece may only move along the line through its king
+            targets &= lineThrough(king, from);
+        }
+        while(targets){
+            validMoves.push_back(Move{from, popLsb(targets)});
+        }
+    }
+
+    // Pawns move as a set, every target is found with a few shifts instead of a loop per pawn.
+    // Pushes onto the last row are promotions and so belong with the captures
+    Bitboard singlePushes = shift<Up>(pawns) & ~occupied;
+    if(Stage != QUIETS){
+        addPawnMoves<Us, Up - 1>(shift<Up - 1>(pawns) & occupancy[Them] & checkMask, pinned, king, validMoves);
+        addPawnMoves<Us, Up + 1>(shift<Up + 1>(pawns) & occupancy[Them] & checkMask, pinned, king, validMoves);
+        addPawnMoves<Us, Up>(singlePushes & promotionRank & checkMask, pinned, king, validMoves);
+    }
+    if(Stage != CAPTURES){
+        Bitboard doublePushes = shift<Up>(singlePushes & relativeRank<Us>(2)) & ~occupied;
+        addPawnMoves<Us, Up>(singlePushes & ~promotionRank & checkMask, pinned, king, validMoves);
+        addPawnMoves<Us, 2 * Up>(doublePushes & checkMask, pinned, king, validMoves);
+    }
+
+    if(Stage != QUIETS && enPassantSquare != NO_SQUARE){
+        Bitboard capturers = pawnAttacks(Them, enPassantSquare) & pawns;
+        while(capturers){
+            Move move{popLsb(capturers), enPassantSquare, Move::EN_PASSANT};
+            if(enPassantKeepsKingSafe<Us>(move)){
+                validMoves.push_back(move);
+            }
+        }
+    }
+}
+
+bool Position::hasLegalMove(Colour us) const{
+    return us == WHITE ? hasLegalMove<WHITE>() : hasLegalMove<BLACK>();
+}
+
+// Whether any pawn target can be reached, with its pawn standing Step squares behind it
+template<int Step> static bool anyPawnMove(Bitboard targets, Bitboard pinned, int king){
+    while(targets){
+        int to = popLsb(targets);
+        int from = to - Step;
+        if(!(pinned & squareBB(from)) || (lineThrough(king, from) & squareBB(to))){
+            return true;
+        }
+    }
+    return false;
+}
+
+template<Colour Us> bool Position::hasLegalMove() const{
+    // The same rules as generateMoves, tried roughly from the likeliest move to the least
+    constexpr Colour Them = opposite(Us);
+    constexpr int Up = pawnPush<Us>;
+    Bitboard occupied = occupancy[WHITE] | occupancy[BLACK];
+    Bitboard kingBB = pieceBoards[pieceIndex(Us, KING)];
+    if(!kingBB){
+        throw InternalErrorException{"Internal Error: King not found"};
+    }
+    int king = lsb(kingBB);
+
+    Bitboard checkers = (attackMaps[Them] & kingBB) ? attackersTo(king, occupied) & occupancy[Them] : 0;
+    Bitboard danger = checkers ? attackedSquares<Them>(occupied ^ kingBB) : attackMaps[Them];
+    // castling is never needed here, a king that may castle may also take the first step on its own
+    if(kingAttacks(king) & ~occupancy[Us] & ~danger){
+        return true;
+    }
+    if(popCount(checkers) > 1){
+        return false;
+    }
+
+    Bitboard checkMask = checkers ? checkers | betweenSquares(king, lsb(checkers)) : ~Bitboard{0};
+    Bitboard pinned = pinnedPieces<Us>();
+    Bitboard pawns = pieceBoards[pieceIndex(Us, PAWN)];
+    // in check the pieces able to take the checker are looked at first
+    Bitboard pieces = occupancy[Us] & ~kingBB & ~pawns;
+    Bitboard first = checkers ? pieces & attackersTo(lsb(checkers), occupied) : 0;
+    for(Bitboard group : {first, pieces & ~first}){
+        while(group){
+            int from = popLsb(group);
+            Bitboard targets = attacksFrom(pieceOn(from), from, occupied) & checkMask & ~occupancy[Us];
+            if(pinned & squareBB(from)){
+                targets &= lineThrough(king, from);
+            }
+            if(targets){
+                return true;
+            }
+        }
+    }
+
+    Bitboard singlePushes = shift<Up>(pawns) & ~occupied;
+    if(anyPawnMove<Up - 1>(shift<Up - 1>(pawns) & occupancy[Them] & checkMask, pinned, king)
+        || anyPawnMove<Up + 1>(shift<Up + 1>(pawns) & occupancy[Them] & checkMask, pinned, king)
+        || anyPawnMove<Up>(singlePushes & checkMask, pinned, king)
+        || anyPawnMove<2 * Up>(shift<Up>(singlePushes & relativeRank<Us>(2)) & ~occupied & checkMask, pinned, king)){
+        return true;
+    }
+
+    if(enPassantSquare != NO_SQUARE){
+        Bitboard capturers = pawnAttacks(Them, enPassantSquare) & pawns;
+        while(capturers){
+            if(enPassantKeepsKingSafe<Us>(Move{popLsb(capturers), enPassantSquare, Move::EN_PASSANT})){
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+uint64_t Position::perft(int depth, std::ostream *divide){
+    // Looser than validChessboard so positions with the side to move in check can be counted,
+    // but the generator still needs both kings and must never be able to capture one
+    if(popCount(pieceBoards[pieceIndex(WHITE, KING)]) != 1 || popCount(pieceBoards[pieceIndex(BLACK, KING)]) != 1
+        || (attackMaps[sideToMove] & pieceBoards[pieceIndex(opposite(sideToMove), KING)])){
+        throw InvalidInputException{"Invalid input: perft needs one king per side and the side not to move out of check"};
+    }
+    if(!divide || depth == 0){
+        return sideToMove == WHITE ? countLeaves<WHITE>(depth) : countLeaves<BLACK>(depth);
+    }
+    MoveList moves = getAllMoves(sideToMove);
+    uint64_t nodes = 0;
+    for(const Move &move : moves){
+        Undo undo = makeMove(move);
+        uint64_t count = sideToMove == WHITE ? countLeaves<WHITE>(depth - 1) : countLeaves<BLACK>(depth - 1);
+        unmakeMove(move, undo);
+        *divide << move.toString() << ": " << count << std::endl;
+        nodes += count;
+    }
+    return nodes;
+}
+
+template<Colour Us> uint64_t Position::countLeaves(int depth){
+    if(depth == 0){
+        return 1;
+    }
+    MoveList moves;
+    generateMoves<Us, ALL_MOVES>(moves);
+    if(depth == 1){
+        // every generated move is legal, so the last ply is just counted
+        return moves.size();
+    }
+    uint64_t nodes = 0;
+    for(const Move &move : moves){
+        Undo undo = makeMove(move);
+        nodes += countLeaves<opposite(Us)>(depth - 1);
+        unmakeMove(move, undo);
+    }
+    return nodes;
+}
+
+int Position::pieceOn(int square) const {
+    return squares[square].index();
+}
+
+void Position::placePiece(int piece, int square) {
+    pieceBoards[piece] |= squareBB(square);
+    occupancy[colourOf(piece)] |= squareBB(square);
+    squares[square] = Piece{piece};
+    key ^= zobrist.pieces[piece][square];
+}
+
+void Position::liftPiece(int square) {
+    int piece = pieceOn(square);
+    if(piece != NO_PIECE) {
+        pieceBoards[piece] &= ~squareBB(square);
+        occupancy[colourOf(piece)] &= ~squareBB(square);
+        squares[square] = Piece{};
+        key ^= zobrist.pieces[piece][square];
+    }
+}
+
+int Position::castlingRightsLost(int square) {
+    switch (square) {
+        case 0: return WHITE_QUEENSIDE;
+        case 4: return WHITE_KINGSIDE | WHITE_QUEENSIDE;
+        case 7: return WHITE_KINGSIDE;
+        case 56: return BLACK_QUEENSIDE;
+        case 60: return BLACK_KINGSIDE | BLACK_QUEENSIDE;
+        case 63: return BLACK_KINGSIDE;
+        default: return 0;
+    }
+}
+
+Undo Position::makeMove(Move move) {
+    int from = move.from();
+    int to = move.to();
+    int piece = pieceOn(from);
+    Colour us = colourOf(piece);
+    Undo undo{pieceOn(to), castlingRights, enPassantSquare, fiftyMoveDrawCount, {attackMaps[WHITE], attackMaps[BLACK]}, key};
+
+    if(move.type() == Move::EN_PASSANT) {
+        // the captured pawn sits beside the moving pawn, not on the target square
+        int capturedSquare = squareOf(rowOf(from), colOf(to));
+        undo.captured = pieceOn(capturedSquare);
+        liftPiece(capturedSquare);
+    }
+    liftPiece(to);
+    liftPiece(from);
+    placePiece(move.type() == Move::PROMOTION ? pieceIndex(us, move.promotion()) : piece, to);
+    if(move.type() == Move::CASTLING) {
+        // the rook jumps over the king
+        bool kingside = to > from;
+        liftPiece(squareOf(rowOf(from), kingside ? 7 : 0));
+        placePiece(pieceIndex(us, ROOK), squareOf(rowOf(from), kingside ? 5 : 3));
+    }
+
+    // a double pawn push can only be captured en passant on the very next move, the square
+    // is only kept when an enemy pawn stands ready so the key does not split equal positions
+    if(enPassantSquare != NO_SQUARE) key ^= zobrist.enPassant[colOf(enPassantSquare)];
+    enPassantSquare = NO_SQUARE;
+    if(typeOf(piece) == PAWN && abs(to - from) == 16 && (pawnAttacks(us, (from + to) / 2) & pieceBoards[pieceIndex(opposite(us), PAWN)])){
+        enPassantSquare = (from + to) / 2;
+        key ^= zobrist.enPassant[colOf(enPassantSquare)];
+    }
+    key ^= zobrist.castling[castlingRights];
+    castlingRights &= ~(castlingRightsLost(from) | castlingRightsLost(to));
+    key ^= zobrist.castling[castlingRights];
+    sideToMove = opposite(sideToMove);
+    key ^= zobrist.blackToMove;
+
+    // Increment 50 move counter if no pawn moved and no capture made
+    if(undo.captured == NO_PIECE && typeOf(piece) != PAWN){
+        fiftyMoveDrawCount++;
+    }
+    else{
+        fiftyMoveDrawCount = 0;
+    }
+    updateAttackMaps();
+    return undo;
+}
+
+void Position::unmakeMove(Move move, const Undo &undo) {
+    int from = move.from();
+    int to = move.to();
+    int piece = pieceOn(to);
+    Colour us = colourOf(piece);
+    liftPiece(to);
+    placePiece(move.type() == Move::PROMOTION ? pieceIndex(us, PAWN) : piece, from);
+
+    if(move.type() == Move::CASTLING) {
+        bool kingside = to > from;
+        liftPiece(squareOf(rowOf(from), kingside ? 5 : 3));
+        placePiece(pieceIndex(us, ROOK), squareOf(rowOf(from), kingside ? 7 : 0));
+    }
+    if(undo.captured != NO_PIECE) {
+        placePiece(undo.captured, move.type() == Move::EN_PASSANT ? squareOf(rowOf(from), colOf(to)) : to);
+    }
+
+    castlingRights = undo.castlingRights;
+    enPassantSquare = undo.enPassantSquare;
+    fiftyMoveDrawCount = undo.fiftyMoveDrawCount;
+    attackMaps[WHITE] = undo.attackMaps[WHITE];
+    attackMaps[BLACK] = undo.attackMaps[BLACK];
+    sideToMove = opposite(sideToMove);
+    key = undo.key;
+}
+
+uint64_t Position::hash() const {
+    return key;
+}
+
+void Position::resetKey() {
+    // Built from scratch after setup changes, makeMove keeps it up to date from then on
+    key = zobrist.castling[castlingRights];
+    for(int piece = 0; piece < 12; piece++){
+        Bitboard pieces = pieceBoards[piece];
+        while(pieces){
+            key ^= zobrist.pieces[piece][popLsb(pieces)];
+        }
+    }
+    if(enPassantSquare != NO_SQUARE) key ^= zobrist.enPassant[colOf(enPassantSquare)];
+    if(sideToMove == BLACK) key ^= zobrist.blackToMove;
+}
+
+void Position::resetCastlingRights() {
+    // Pieces placed on their home squares have not moved yet
+    key ^= zobrist.castling[castlingRights];
+    castlingRights = 0;
+    if(pieceOn(4) == pieceIndex(WHITE, KING)) {
+        if(pieceOn(7) == pieceIndex(WHITE, ROOK)) castlingRights |= WHITE_KINGSIDE;
+        if(pieceOn(0) == pieceIndex(WHITE, ROOK)) castlingRights |= WHITE_QUEENSIDE;
+    }
+    if(pieceOn(60) == pieceIndex(BLACK, KING)) {
+        if(pieceOn(63) == pieceIndex(BLACK, ROOK)) castlingRights |= BLACK_KINGSIDE;
+        if(pieceOn(56) == pieceIndex(BLACK, ROOK)) castlingRights |= BLACK_QUEENSIDE;
+    }
+    key ^= zobrist.castling[castlingRights];
+}
+
+void Position::checkEnPassantSquare() {
+    // Same rule as makeMove, plus the square has to be empty with the pawn that just moved two squares in front of it
+    if(enPassantSquare == NO_SQUARE) return;
+    Colour them = opposite(sideToMove);
+    int pushed = enPassantSquare + (sideToMove == WHITE ? -8 : 8);
+    if(pieceOn(enPassantSquare) != NO_PIECE || pieceOn(pushed) != pieceIndex(them, PAWN)
+        || !(pawnAttacks(them, enPassantSquare) & pieceBoards[pieceIndex(sideToMove, PAWN)])){
+        enPassantSquare = NO_SQUARE;
+    }
+}
+
+Bitboard Position::attacksFrom(int piece, int square, Bitboard occupied) const {
+    switch (typeOf(piece)) {
+        case PAWN: return pawnAttacks(colourOf(piece), square);
+        case KNIGHT: return knightAttacks(square);
+        case BISHOP: return bishopAttacks(square, occupied);
+        case ROOK: return rookAttacks(square, occupied);
+        case QUEEN: return queenAttacks(square, occupied);
+        case KING: return kingAttacks(square);
+    }
+    return 0;
+}
+
+template<Colour By> bool Position::isSquareAttacked(int square, Bitboard occupied) const {
+    // Look outwards from the square with each piece's attack pattern and intersect with that piece's bitboard
+    Bitboard queens = pieceBoards[pieceIndex(By, QUEEN)];
+    return (pawnAttacks(opposite(By), square) & pieceBoards[pieceIndex(By, PAWN)])
+        || (knightAttacks(square) & pieceBoards[pieceIndex(By, KNIGHT)])
+        || (kingAttacks(square) & pieceBoards[pieceIndex(By, KING)])
+        || (bishopAttacks(square, occupied) & (pieceBoards[pieceIndex(By, BISHOP)] | queens))
+        || (rookAttacks(square, occupied) & (pieceBoards[pieceIndex(By, ROOK)] | queens));
+}
+
+Bitboard Position::attackersTo(int square, Bitboard occupied) const {
+    // Attackers of both colours, sliders are blocked by the given occupancy
+    Bitboard bishopsQueens = pieceBoards[pieceIndex(WHITE, BISHOP)] | pieceBoards[pieceIndex(BLACK, BISHOP)]
+        | pieceBoards[pieceIndex(WHITE, QUEEN)] | pieceBoards[pieceIndex(BLACK, QUEEN)];
+    Bitboard rooksQueens = pieceBoards[pieceIndex(WHITE, ROOK)] | pieceBoards[pieceIndex(BLACK, ROOK)]
+        | pieceBoards[pieceIndex(WHITE, QUEEN)] | pieceBoards[pieceIndex(BLACK, QUEEN)];
+    return (pawnAttacks(BLACK, square) & pieceBoards[pieceIndex(WHITE, PAWN)])
+        | (pawnAttacks(WHITE, square) & pieceBoards[pieceIndex(BLACK, PAWN)])
+        | (knightAttacks(square) & (pieceBoards[pieceIndex(WHITE, KNIGHT)] | pieceBoards[pieceIndex(BLACK, KNIGHT)]))
+        | (kingAttacks(square) & (pieceBoards[pieceIndex(WHITE, KING)] | pieceBoards[pieceIndex(BLACK, KING)]))
+        | (bishopAttacks(square, occupied) & bishopsQueens)
+        | (rookAttacks(square, occupied) & rooksQueens);
+}
+
+template<Colour By> Bitboard Position::attackedSquares(Bitboard occupied) const {
+    // all pawns at once, then every other piece from its own square
+    Bitboard pawns = pieceBoards[pieceIndex(By, PAWN)];
+    Bitboard attacked = pawnAttacks<By>(pawns);
+    Bitboard pieces = occupancy[By] & ~pawns;
+    while(pieces){
+        int square = popLsb(pieces);
+        attacked |= attacksFrom(pieceOn(square), square, occupied);
+    }
+    return attacked;
+}
+
+void Position::updateAttackMaps(){
+    // Rebuilt once per move so attack queries between moves are a single bit test,
+    // unmakeMove restores the previous maps from the Undo instead of rebuilding
+    Bitboard occupied = occupancy[WHITE] | occupancy[BLACK];
+    attackMaps[WHITE] = attackedSquares<WHITE>(occupied);
+    attackMaps[BLACK] = attackedSquares<BLACK>(occupied);
+}
+
+template<Colour Us> Bitboard Position::pinnedPieces() const {
+    constexpr Colour Them = opposite(Us);
+    int king = lsb(pieceBoards[pieceIndex(Us, KING)]);
+    Bitboard occupied = occupancy[WHITE] | occupancy[BLACK];
+    Bitboard queens = pieceBoards[pieceIndex(Them, QUEEN)];
+    // enemy sliders that would hit the king on an empty board
+    Bitboard snipers = (rookAttacks(king, 0) & (pieceBoards[pieceIndex(Them, ROOK)] | queens))
+        | (bishopAttacks(king, 0) & (pieceBoards[pieceIndex(Them, BISHOP)] | queens));
+    Bitboard pinned = 0;
+    while(snipers){
+        Bitboard blockers = betweenSquares(king, popLsb(snipers)) & occupied;
+        if(popCount(blockers) == 1){
+            pinned |= blockers & occupancy[Us];
+        }
+    }
+    return pinned;
+}
+
+template<Colour Us> bool Position::enPassantKeepsKingSafe(Move move) const {
+    // en passant empties two squares on one row, so the king is tested against the resulting occupancy
+    int king = lsb(pieceBoards[pieceIndex(Us, KING)]);
+    int capturedSquare = move.to() - pawnPush<Us>;
+    Bitboard occupied = ((occupancy[WHITE] | occupancy[BLACK]) ^ squareBB(move.from()) ^ squareBB(capturedSquare)) | squareBB(move.to());
+    return !(attackersTo(king, occupied) & occupancy[opposite(Us)] & ~squareBB(capturedSquare));
+}
+
+template<Colour Us> bool Position::keepsKingSafe(Move move) const {
+    constexpr Colour Them = opposite(Us);
+    Bitboard kingBB = pieceBoards[pieceIndex(Us, KING)];
+    int king = lsb(kingBB);
+    Bitboard occupied = occupancy[WHITE] | occupancy[BLACK];
+    if(move.from() == king){
+        // castling already checked the squares the king passes over
+        return !isSquareAttacked<Them>(move.to(), occupied ^ kingBB);
+    }
+    if(move.type() == Move::EN_PASSANT){
+        return enPassantKeepsKingSafe<Us>(move);
+    }
+    Bitboard checkers = attackersTo(king, occupied) & occupancy[Them];
+    if(popCount(checkers) > 1){
+        return false;
+    }
+    if(checkers && !((checkers | betweenSquares(king, lsb(checkers))) & squareBB(move.to()))){
+        return false;
+    }
+    return !(pinnedPieces<Us>() & squareBB(move.from())) || (lineThrough(king, move.from()) & squareBB(move.to()));
+}
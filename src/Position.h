@@ -0,0 +1,102 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <cstdint>
+#include <string>
+#include <iostream>
+#include <type_traits>
+#include "Bitboard.h"
+#include "Move.h"
+#include "MoveList.h"
+#include "Piece.h"
+
+// Which moves a generator pass produces. Captures include every promotion and en passant,
+// quiets are all the rest, so the two stages together give every legal move exactly once
+enum MoveStage { CAPTURES, QUIETS, ALL_MOVES };
+
+// The pure chess position: pieces, side to move, castling and en passant rights and the
+// fifty move counter. It holds plain data only, so search and validation can copy it freely
+// without touching the heap, the game session around it lives in Chessboard
+class Position {
+    public:
+        // An empty board with white to move
+        Position();
+
+        // Setup, each keeps castling rights, attack maps and the key in step with the pieces
+        void clear(Colour side);
+        // Replace whatever is on the square, NO_PIECE empties it
+        void setPiece(int square, int piece);
+        void setSideToMove(Colour side);
+        void loadFen(std::string fen);
+        // Every castling right whose king and rook stand on their home squares, for boards set up piece by piece
+        void resetCastlingRights();
+
+        Piece pieceAt(int square) const;
+        Bitboard pieces(Colour colour, PieceType type) const;
+        Colour getSideToMove() const;
+        int getEnPassantSquare() const;
+        int getFiftyMoveDrawCount() const;
+        // Zobrist key of the position, equal positions with the same side to move share a key
+        uint64_t hash() const;
+        bool isSquareAttacked(int square, Colour by) const;
+        // Every square the colour attacks
+        Bitboard getAttackMap(Colour by) const;
+        bool inCheck(Colour colour) const;
+        bool isDeadPosition() const;
+        // No more than a game could produce: at most 16 pieces a side, extra pieces paid for with pawns.
+        // Move lists have room for every position that passes
+        bool hasReachableMaterial() const;
+
+        MoveStatus tryMove(Move move, Colour player) const;
+        bool isLegal(Move move) const;
+        // Whether the legal move would check the opponent, worked out without playing it
+        bool givesCheck(Move move) const;
+        MoveList getAllMoves(Colour us) const;
+        MoveList getMoves(Colour us, MoveStage stage) const;
+        // Same answer as !getAllMoves(us).empty(), but stops at the first legal move found
+        bool hasLegalMove(Colour us) const;
+        Undo makeMove(Move move);
+        void unmakeMove(Move move, const Undo &undo);
+        // Number of leaf positions depth moves ahead, with divide the count below each root move is printed too
+        uint64_t perft(int depth, std::ostream *divide = nullptr);
+    private:
+        enum CastlingRight { WHITE_KINGSIDE = 1, WHITE_QUEENSIDE = 2, BLACK_KINGSIDE = 4, BLACK_QUEENSIDE = 8 };
+        int pieceOn(int square) const;
+        void placePiece(int piece, int square);
+        void liftPiece(int square);
+        static int castlingRightsLost(int square);
+        // Drops an en passant square that setup edits have made impossible
+        void checkEnPassantSquare();
+        void updateAttackMaps();
+        void resetKey();
+        Bitboard attacksFrom(int piece, int square, Bitboard occupied) const;
+        Bitboard attackersTo(int square, Bitboard occupied) const;
+        // The side is a template argument below, so pawn directions, promotion rows and castling
+        // squares are constants. The public functions dispatch on the colour once per call
+        template<Colour Us> MoveStatus tryMove(Move move) const;
+        template<Colour Us, MoveStage Stage> void generateMoves(MoveList &validMoves) const;
+        template<Colour Us> bool hasLegalMove() const;
+        template<Colour Us> bool givesCheck(Move move) const;
+        template<Colour By> bool isSquareAttacked(int square, Bitboard occupied) const;
+        template<Colour By> Bitboard attackedSquares(Bitboard occupied) const;
+        template<Colour Us> Bitboard pinnedPieces() const;
+        template<Colour Us> bool enPassantKeepsKingSafe(Move move) const;
+        template<Colour Us> bool keepsKingSafe(Move move) const;
+        template<Colour Us> uint64_t countLeaves(int depth);
+        // 12 piece bitboards indexed by pieceIndex, plus per colour occupancy
+        Bitboard pieceBoards[12];
+        Bitboard occupancy[2];
+        // squares each colour attacks in the current position, refreshed whenever pieces move
+        Bitboard attackMaps[2];
+        // the same pieces one byte per square, so the piece on a square is a single lookup
+        Piece squares[64];
+        int castlingRights;
+        int enPassantSquare;
+        Colour sideToMove;
+        int fiftyMoveDrawCount;
+        uint64_t key;
+};
+
+static_assert(std::is_trivially_copyable_v<Position>, "Position must stay plain data so copies are a memcpy");
+
+#endif
@@ -0,0 +1,365 @@
+#include "Search.h"
+#include "Computer.h"
+#include "MoveGenerator.h"
+#include "./exceptions/InternalErrorException.h"
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <thread>
+
+Search::Search(SearchOptions options) : options{options}, table{options.hash}, workers(std::clamp(options.threads, 1, MAX_THREADS)),
+    stopped{false}, chosen{0}, seconds{0} {
+    for(size_t i = 0; i < workers.size(); i++){
+        workers[i].id = i;
+    }
+}
+
+// Mate scores count plies from the root, the table holds them counted from the stored position
+// so they stay right when the position turns up again at another ply
+static int scoreToTable(int score, int ply){
+    if(score >= Search::MATE_SCORE - Search::MAX_PLY) return score + ply;
+    if(score <= -Search::MATE_SCORE + Search::MAX_PLY) return score - ply;
+    return score;
+}
+
+static int scoreFromTable(int score, int ply){
+    if(score >= Search::MATE_SCORE - Search::MAX_PLY) return score - ply;
+    if(score <= -Search::MATE_SCORE + Search::MAX_PLY) return score + ply;
+    return score;
+}
+
+Move Search::bestMove(Position &position){
+    auto start = std::chrono::steady_clock::now();
+    MoveList rootMoves = position.getAllMoves(position.getSideToMove());
+    if(rootMoves.empty()){
+        throw InternalErrorException{"Computer generated no moves"};
+    }
+    stopped = false;
+    table.newSearch();
+    for(Worker &worker : workers){
+        prepare(worker);
+    }
+
+    // The helpers get their own copies of the position and stop as soon as the main thread is done
+    std::vector<std::thread> helpers;
+    for(size_t i = 1; i < workers.size(); i++){
+        helpers.emplace_back([this, i, copy = position, rootMoves]() mutable {
+            iterate(workers[i], copy, rootMoves);
+        });
+    }
+    iterate(workers[0], position, rootMoves);
+    stopped = true;
+    for(std::thread &helper : helpers){
+        helper.join();
+    }
+
+    // a helper that finished a deeper iteration than the main thread has the better informed move
+    chosen = 0;
+    for(size_t i = 1; i < workers.size(); i++){
+        if(workers[i].completedDepth > workers[chosen].completedDepth){
+            chosen = i;
+        }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return workers[chosen].best;
+}
+
+void Search::prepare(Worker &worker){
+    worker.nodes = 0;
+    worker.hashProbes = 0;
+    worker.hashHits = 0;
+    worker.cutoffs = 0;
+    worker.firstMoveCutoffs = 0;
+    // killers are tied to the plies of the last search, history still hints at good moves so is only halved
+    for(auto &ply : worker.killers){
+        ply[0] = ply[1] = Move{};
+    }
+    for(auto &side : worker.history){
+        for(auto &from : side){
+            for(int &score : from){
+                score /= 2;
+            }
+        }
+    }
+    worker.best = Move{};
+    worker.completedDepth = 0;
+    worker.score = 0;
+}
+
+void Search::iterate(Worker &worker, Position &position, MoveList rootMoves){
+    worker.best = rootMoves[0];
+    int maxDepth = options.depth > 0 && options.depth < MAX_PLY ? options.depth : MAX_PLY;
+    worker.pathKeys[0] = position.hash();
+
+    // every second helper starts a ply deeper, so the threads spread over two depths and fill the
+    // table with results the others can use instead of all searching the same tree in step
+    for(int depth = 1 + worker.id % 2; depth <= maxDepth; depth++){
+        int alpha = -MATE_SCORE - 1;
+        size_t bestIndex = 0;
+        for(size_t i = 0; i < rootMoves.size(); i++){
+            Undo undo = position.makeMove(rootMoves[i]);
+            int moveScore = -negamax(worker, position, depth - 1, 1, -MATE_SCORE - 1, -alpha);
+            position.unmakeMove(rootMoves[i], undo);
+            if(stopped){
+                break;
+            }
+            if(moveScore > alpha){
+                alpha = moveScore;
+                bestIndex = i;
+            }
+        }
+        // An unfinished iteration still searched the previous best move first, so anything
+        // that beat it is a safe choice. Nothing finished means nothing new was learned
+        if(alpha > -MATE_SCORE - 1){
+            worker.best = rootMoves[bestIndex];
+            worker.score = alpha;
+            // the best move leads the next iteration, the rest keep their order
+            MoveList reordered;
+            reordered.push_back(worker.best);
+            for(const Move &move : rootMoves){
+                if(move != worker.best) reordered.push_back(move);
+            }
+            rootMoves = reordered;
+        }
+        if(stopped){
+            break;
+        }
+        worker.completedDepth = depth;
+        // a forced mate either way will not change with more depth
+        if(abs(worker.score) >= MATE_SCORE - MAX_PLY){
+            break;
+        }
+    }
+}
+
+bool Search::outOfNodes(Worker &worker){
+    // the first iteration always finishes, so there is a move to play however small the limit
+    if(worker.id == 0 && options.nodes && worker.nodes >= options.nodes && worker.completedDepth > 0){
+        stopped = true;
+    }
+    return stopped;
+}
+
+int Search::negamax(Worker &worker, Position &position, int depth, int ply, int alpha, int beta){
+    if(outOfNodes(worker)){
+        return 0;
+    }
+    worker.nodes++;
+    worker.pathKeys[ply] = position.hash();
+    Colour us = position.getSideToMove();
+
+    // The game ends on these before the side to move gets to play, unless it has been mated
+    if(position.getFiftyMoveDrawCount() >= 50 || position.isDeadPosition()){
+        return !position.hasLegalMove(us) && position.inCheck(us) ? -MATE_SCORE + ply : 0;
+    }
+    // going round in a circle gains nothing, so the repeat is scored as a draw
+    if(isRepetition(worker, ply)){
+        return 0;
+    }
+    if(ply >= MAX_PLY){
+        return evaluate(position);
+    }
+    if(depth <= 0){
+        return quiescence(worker, position, ply, alpha, beta);
+    }
+
+    // A result from at least this deep settles the node if its bound is on the right side of the window
+    TranspositionTable::Entry entry;
+    Move hashMove{};
+    worker.hashProbes++;
+    if(table.probe(position.hash(), entry)){
+        worker.hashHits++;
+        hashMove = entry.move;
+        int stored = scoreFromTable(entry.score, ply);
+        if(entry.depth >= depth && (entry.bound == EXACT_BOUND || (entry.bound == LOWER_BOUND && stored >= beta)
+                || (entry.bound == UPPER_BOUND && stored <= alpha))){
+            return stored;
+        }
+    }
+
+    int originalAlpha = alpha;
+    MoveGenerator moves{position, hashMove, worker.killers[ply], worker.history[us]};
+    Move move;
+    Move bestMove{};
+    int best = -MATE_SCORE - 1;
+    int searched = 0;
+    while(moves.next(move)){
+        searched++;
+        Undo undo = position.makeMove(move);
+        int moveScore = -negamax(worker, position, depth - 1, ply + 1, -beta, -alpha);
+        position.unmakeMove(move, undo);
+        if(stopped){
+            return 0;
+        }
+        if(moveScore > best){
+            best = moveScore;
+            bestMove = move;
+        }
+        if(moveScore > alpha){
+            alpha = moveScore;
+        }
+        if(alpha >= beta){
+            // the opponent already has a better option earlier on, no need to look further
+            worker.cutoffs++;
+            worker.firstMoveCutoffs += searched == 1;
+            if(moves.currentStage() == QUIETS){
+                rewardQuiet(worker, move, us, depth, ply);
+            }
+            break;
+        }
+    }
+    if(!searched){
+        // checkmate, sooner is worse, or stalemate
+        best = position.inCheck(us) ? -MATE_SCORE + ply : 0;
+        table.store(position.hash(), Move{}, scoreToTable(best, ply), depth, EXACT_BOUND);
+        return best;
+    }
+    // when nothing beat alpha no move here is known to be best, so none is stored
+    Bound bound = best >= beta ? LOWER_BOUND : best > originalAlpha ? EXACT_BOUND : UPPER_BOUND;
+    table.store(position.hash(), bound == UPPER_BOUND ? Move{} : bestMove, scoreToTable(best, ply), depth, bound);
+    return best;
+}
+
+void Search::rewardQuiet(Worker &worker, Move move, Colour us, int depth, int ply){
+    // A quiet move that refutes one position often refutes its siblings too. Killers keep the last
+    // two such moves per ply, history counts them for the whole search, weighted towards deep cutoffs.
+    // Each bonus closes part of the gap to HISTORY_MAX, so scores never overflow
+    if(worker.killers[ply][0] != move){
+        worker.killers[ply][1] = worker.killers[ply][0];
+        worker.killers[ply][0] = move;
+    }
+    int bonus = std::min(depth * depth, 400);
+    int &score = worker.history[us][move.from()][move.to()];
+    score += bonus - score * bonus / HISTORY_MAX;
+}
+
+void Search::clear(){
+    table.clear();
+    for(Worker &worker : workers){
+        for(auto &side : worker.history){
+            for(auto &from : side){
+                std::fill(std::begin(from), std::end(from), 0);
+            }
+        }
+    }
+}
+
+int Search::quiescence(Worker &worker, Position &position, int ply, int alpha, int beta){
+    // Only captures and promotions are searched, until the position is quiet enough for evaluate to be
+    // trusted. Out of check the side to move may stand pat instead, so evaluate is already a lower bound.
+    // In check every evasion is searched, since standing pat is not an option there
+    Colour us = position.getSideToMove();
+    bool inCheck = position.inCheck(us);
+    int standPat = evaluate(position);
+    int best = -MATE_SCORE - 1;
+    if(!inCheck){
+        best = standPat;
+        if(best >= beta){
+            return best;
+        }
+        alpha = std::max(alpha, best);
+    }
+    if(ply >= MAX_PLY){
+        return standPat;
+    }
+
+    static const Move noKillers[2] = {};
+    MoveGenerator moves = inCheck ? MoveGenerator{position, Move{}, noKillers, worker.history[us]} : MoveGenerator::capturesOf(position);
+    Move move;
+    bool anyMove = false;
+    while(moves.next(move)){
+        anyMove = true;
+        // delta pruning, a capture that would not reach alpha even with a margin to spare is not tried
+        if(!inCheck && standPat + 100 * MoveGenerator::captureGain(position, move) + DELTA_MARGIN <= alpha){
+            continue;
+        }
+        // nor is one that gives up a more valuable piece for a defended one, it rarely wins anything
+        if(!inCheck && move.type() != Move::PROMOTION && MoveGenerator::captureGain(position, move) < Computer::pieceValues[position.pieceAt(move.from()).type()]
+                && position.isSquareAttacked(move.to(), opposite(us))){
+            continue;
+        }
+        if(outOfNodes(worker)){
+            return 0;
+        }
+        worker.nodes++;
+        Undo undo = position.makeMove(move);
+        int moveScore = -quiescence(worker, position, ply + 1, -beta, -alpha);
+        position.unmakeMove(move, undo);
+        if(stopped){
+            return 0;
+        }
+        best = std::max(best, moveScore);
+        alpha = std::max(alpha, moveScore);
+        if(alpha >= beta){
+            break;
+        }
+    }
+    if(inCheck && !anyMove){
+        return -MATE_SCORE + ply;
+    }
+    return best;
+}
+
+bool Search::isRepetition(const Worker &worker, int ply) const{
+    // only positions with the same side to move can repeat, every second ply back
+    for(int i = ply - 2; i >= 0; i -= 2){
+        if(worker.pathKeys[i] == worker.pathKeys[ply]){
+            return true;
+        }
+    }
+    return false;
+}
+
+int Search::evaluate(const Position &position) const{
+    // Material from Computer::pieceValues in centipawns, plus a little for every square attacked
+    // so the pieces get developed. The attack maps are already kept up to date by makeMove
+    Colour us = position.getSideToMove();
+    Colour them = opposite(us);
+    int material = 0;
+    for(PieceType type : {PAWN, KNIGHT, BISHOP, ROOK, QUEEN}){
+        material += Computer::pieceValues[type] * (popCount(position.pieces(us, type)) - popCount(position.pieces(them, type)));
+    }
+    int mobility = popCount(position.getAttackMap(us)) - popCount(position.getAttackMap(them));
+    return 100 * material + 2 * mobility;
+}
+
+uint64_t Search::getNodes() const{
+    uint64_t nodes = 0;
+    for(const Worker &worker : workers){
+        nodes += worker.nodes;
+    }
+    return nodes;
+}
+
+int Search::getCompletedDepth() const{
+    return workers[chosen].completedDepth;
+}
+
+void Search::printStats(std::ostream &out) const{
+    uint64_t nodes = 0, hashProbes = 0, hashHits = 0, cutoffs = 0, firstMoveCutoffs = 0;
+    for(const Worker &worker : workers){
+        nodes += worker.nodes;
+        hashProbes += worker.hashProbes;
+        hashHits += worker.hashHits;
+        cutoffs += worker.cutoffs;
+        firstMoveCutoffs += worker.firstMoveCutoffs;
+    }
+    int score = workers[chosen].score;
+    out << "Search: depth " << workers[chosen].completedDepth << ", score ";
+    if(abs(score) >= MATE_SCORE - MAX_PLY){
+        // plies to mate, rounded up to whole moves
+        int moves = (MATE_SCORE - abs(score) + 1) / 2;
+        out << (score > 0 ? "mate in " : "mated in ") << moves;
+    }
+    else{
+        out << (score >= 0 ? "+" : "-") << abs(score) / 100 << "." << (abs(score) % 100 < 10 ? "0" : "") << abs(score) % 100;
+    }
+    out << ", nodes " << nodes << ", " << seconds << "s, "
+        << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0) << " nodes/s, hash hits "
+        << (hashProbes ? 100 * hashHits / hashProbes : 0) << "%, first move cutoffs "
+        << (cutoffs ? 100 * firstMoveCutoffs / cutoffs : 0) << "%";
+    if(workers.size() > 1){
+        out << ", threads " << workers.size();
+    }
+    out << std::endl;
+}
@@ -0,0 +1,88 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include "Position.h"
+#include "TranspositionTable.h"
+#include "MoveGenerator.h"
+
+// How far a search may go, a limit left at 0 is not applied, how many megabytes its
+// transposition table takes and how many threads search at once
+struct SearchOptions {
+    int depth = 0;
+    uint64_t nodes = 0;
+    size_t hash = 16;
+    int threads = 1;
+};
+
+// Iterative deepening negamax with alpha-beta pruning, ending in a quiescence search over captures
+// and promotions so no score is taken in the middle of an exchange. The position is searched in place with
+// makeMove/unmakeMove and handed back unchanged. Scores are in centipawns for the side to move.
+// The transposition table is kept from one bestMove to the next.
+// With more than one thread the search is Lazy SMP: helper threads search the same root on their own
+// copies of the position, every second one a ply deeper than the main thread, and only share what they
+// find through the transposition table. The node limit counts the main thread's nodes only
+class Search {
+    friend class Bench;
+    public:
+        inline static const int MAX_PLY = 64;
+        inline static const int MATE_SCORE = 32000;
+        // largest transposition table in megabytes a game will allocate
+        inline static const size_t MAX_HASH = 4096;
+        inline static const int MAX_THREADS = 64;
+        // history scores stay below this
+        inline static const int HISTORY_MAX = 16384;
+        // centipawns a capture may gain on top of the piece taken before the quiescence search gives up on it
+        inline static const int DELTA_MARGIN = 200;
+        explicit Search(SearchOptions options);
+        Move bestMove(Position &position);
+        // Forget everything stored by earlier searches
+        void clear();
+        // Nodes of every thread in the last search
+        uint64_t getNodes() const;
+        int getCompletedDepth() const;
+        // Depth, score, nodes, speed, hash hit rate and share of cutoffs on the first move of the last search on one line
+        void printStats(std::ostream &out) const;
+    private:
+        // Everything one thread changes while it searches, only the table and stopped are shared.
+        // Aligned so two threads never write to the same cache line
+        struct alignas(64) Worker {
+            int id;
+            uint64_t nodes;
+            uint64_t hashProbes;
+            uint64_t hashHits;
+            uint64_t cutoffs;
+            // cutoffs caused by the first move tried, the closer to all of them the better the ordering
+            uint64_t firstMoveCutoffs;
+            // keys of the positions on the current search path, indexed by ply
+            uint64_t pathKeys[MAX_PLY + 1];
+            Move killers[MAX_PLY + 1][2];
+            HistoryTable history[2];
+            Move best;
+            int completedDepth;
+            int score;
+        };
+        void prepare(Worker &worker);
+        void iterate(Worker &worker, Position &position, MoveList rootMoves);
+        int negamax(Worker &worker, Position &position, int depth, int ply, int alpha, int beta);
+        int quiescence(Worker &worker, Position &position, int ply, int alpha, int beta);
+        // Sets stopped once the main thread has used up the node limit
+        bool outOfNodes(Worker &worker);
+        int evaluate(const Position &position) const;
+        bool isRepetition(const Worker &worker, int ply) const;
+        // Remembers a quiet move that caused a cutoff so it is tried early next time
+        void rewardQuiet(Worker &worker, Move move, Colour us, int depth, int ply);
+        SearchOptions options;
+        TranspositionTable table;
+        // workers[0] belongs to the thread that called bestMove
+        std::vector<Worker> workers;
+        std::atomic<bool> stopped;
+        // the worker whose move bestMove returned
+        size_t chosen;
+        double seconds;
+};
+
+#endif
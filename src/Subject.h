@@ -5,17 +5,18 @@
 #include <iostream>
 #include <memory>
 #include "Observer.h"
-
-// Forward Declarations
-class Piece;
+#include "Piece.h"
 
 class Subject{
     std::vector<std::unique_ptr<Observer>> observers;
     public:
         void attach(std::unique_ptr<Observer> o);
         void detach(std::unique_ptr<Observer> o);
-        void notifyObservers();
-        virtual std::pair<const Piece*, const Piece*> getState(size_t row, size_t col) const = 0;
+        virtual void notifyObservers();
+        // The piece on a square, an empty Piece for an empty square
+        virtual Piece getState(size_t row, size_t col) const = 0;
+        // Squares that may have changed since observers were last notified
+        virtual Bitboard getChangedSquares() const = 0;
         virtual ~Subject();
 };
 
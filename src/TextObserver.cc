@@ -12,8 +12,8 @@ void TextObserver::notify() {
         std::cout << i << ' ';
         for(size_t j = 0; j < Chessboard::BOARD_SIZE; j++){
             // i is row, j is column
-            const Piece* piece = subject->getState(i - 1, j).first;
-            if(piece) std::cout << std::setw(2) << piece->getName();
+            Piece piece = subject->getState(i - 1, j);
+            if(piece) std::cout << std::setw(2) << piece.getName();
             else std::cout << std::setw(2) << ((((Chessboard::BOARD_SIZE - i - 2) + j) % 2 == 0) ? ' ' : '_');
         }
         std::cout << std::endl;
@@ -0,0 +1,95 @@
+#include "TranspositionTable.h"
+#include <algorithm>
+#include <cstring>
+
+// Slot data layout: move (bits 0-15), score (bits 16-31), depth (bits 32-39), bound (bits 40-41), age (bits 42-47)
+static const int AGE_MASK = 0x3F;
+
+static uint64_t pack(Move move, int score, int depth, Bound bound, int age){
+    return uint64_t{move.raw()} | uint64_t{static_cast<uint16_t>(score)} << 16 | uint64_t(depth & 0xFF) << 32
+        | uint64_t(bound) << 40 | uint64_t(age) << 42;
+}
+
+static Bound boundOf(uint64_t data){
+    return static_cast<Bound>((data >> 40) & 0x3);
+}
+
+static int depthOf(uint64_t data){
+    return (data >> 32) & 0xFF;
+}
+
+static int ageOf(uint64_t data){
+    return (data >> 42) & AGE_MASK;
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+    : buckets(std::max<size_t>(1, megabytes * 1024 * 1024 / sizeof(Bucket))), age{0} {}
+
+TranspositionTable::Bucket& TranspositionTable::bucketFor(uint64_t key){
+    // The high half of key * size lands in [0, size), so any bucket count works, not just powers of two
+    return buckets[static_cast<uint64_t>((static_cast<unsigned __int128>(key) * buckets.size()) >> 64)];
+}
+
+const TranspositionTable::Bucket& TranspositionTable::bucketFor(uint64_t key) const{
+    return const_cast<TranspositionTable*>(this)->bucketFor(key);
+}
+
+void TranspositionTable::newSearch(){
+    age = (age + 1) & AGE_MASK;
+}
+
+bool TranspositionTable::probe(uint64_t key, Entry &entry) const{
+    for(const Slot &slot : bucketFor(key).slots){
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if((slot.check.load(std::memory_order_relaxed) ^ data) == key && boundOf(data) != NO_BOUND){
+            entry.move = Move::fromRaw(data & 0xFFFF);
+            entry.score = static_cast<int16_t>((data >> 16) & 0xFFFF);
+            entry.depth = depthOf(data);
+            entry.bound = boundOf(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, Move move, int score, int depth, Bound bound){
+    Bucket &bucket = bucketFor(key);
+    // Reuse the slot already holding this position or an empty one, otherwise push out the entry
+    // worth least: shallow results from old searches go first, deep ones from this search last
+    Slot *replace = nullptr;
+    uint64_t replaceData = 0;
+    bool samePosition = false;
+    int worstWorth = 0;
+    for(Slot &slot : bucket.slots){
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        samePosition = (slot.check.load(std::memory_order_relaxed) ^ data) == key && boundOf(data) != NO_BOUND;
+        if(samePosition || boundOf(data) == NO_BOUND){
+            replace = &slot;
+            replaceData = data;
+            break;
+        }
+        int worth = depthOf(data) - 8 * ((age - ageOf(data)) & AGE_MASK);
+        if(!replace || worth < worstWorth){
+            replace = &slot;
+            replaceData = data;
+            worstWorth = worth;
+        }
+    }
+    // a result without a best move keeps the one found earlier for the same position
+    if(move == Move{} && samePosition){
+        move = Move::fromRaw(replaceData & 0xFFFF);
+    }
+    uint64_t data = pack(move, score, depth, bound, age);
+    replace->check.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear(){
+    // never called while a search is running, so plain zeroing is safe and far quicker than a store per word
+    std::memset(static_cast<void*>(buckets.data()), 0, sizeInBytes());
+    age = 0;
+}
+
+size_t TranspositionTable::sizeInBytes() const{
+    return buckets.size() * sizeof(Bucket);
+}
@@ -0,0 +1,50 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include "Move.h"
+
+// What a stored score says about the real score of the position
+enum Bound { NO_BOUND, UPPER_BOUND, LOWER_BOUND, EXACT_BOUND };
+
+// Search results keyed by Position::hash. All memory is taken when the table is made and never grows,
+// four entries share a 64 byte bucket so a probe reads a single cache line. Search threads share one
+// table without locks: each entry is two relaxed atomic words, the key stored xor the data, so an entry
+// torn by two threads writing at once no longer matches its key and simply reads as a miss
+class TranspositionTable {
+    public:
+        struct Entry {
+            Move move;
+            int score;
+            int depth;
+            Bound bound;
+        };
+        explicit TranspositionTable(size_t megabytes);
+        // Called once per search before any thread starts, entries left over from earlier searches are the first to be replaced
+        void newSearch();
+        bool probe(uint64_t key, Entry &entry) const;
+        void store(uint64_t key, Move move, int score, int depth, Bound bound);
+        // Only while no search is using the table
+        void clear();
+        size_t sizeInBytes() const;
+    private:
+        // The move, score, depth, bound and age packed into one word, next to the full key xor that word
+        struct Slot {
+            std::atomic<uint64_t> check;
+            std::atomic<uint64_t> data;
+        };
+        struct alignas(64) Bucket {
+            Slot slots[4];
+        };
+        static_assert(sizeof(Bucket) == 64, "A bucket must fill exactly one cache line");
+        Bucket& bucketFor(uint64_t key);
+        const Bucket& bucketFor(uint64_t key) const;
+        std::vector<Bucket> buckets;
+        // six bits, wraps around
+        int age;
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+// Random keys xored together to identify a position: one per piece on each square,
+// one per set of castling rights, one per en passant column and one for black to move
+struct ZobristKeys {
+    uint64_t pieces[12][64];
+    uint64_t castling[16];
+    uint64_t enPassant[8];
+    uint64_t blackToMove;
+};
+
+// Generated at compile time from a fixed seed, so keys are the same in every build and run
+inline constexpr ZobristKeys zobrist = [](){
+    ZobristKeys keys{};
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    auto random = [&seed](){
+        seed ^= seed >> 12; seed ^= seed << 25; seed ^= seed >> 27;
+        return seed * 2685821657736338717ULL;
+    };
+    for(auto &piece : keys.pieces){
+        for(uint64_t &key : piece) key = random();
+    }
+    for(uint64_t &key : keys.castling) key = random();
+    for(uint64_t &key : keys.enPassant) key = random();
+    keys.blackToMove = random();
+    return keys;
+}();
+
+#endif
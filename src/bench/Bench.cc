@@ -0,0 +1,221 @@
+#include "Bench.h"
+#include "../Chessboard.h"
+#include "../Computer.h"
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <algorithm>
+
+// Every heap allocation in the process is counted so each benchmark can report allocations per operation
+static uint64_t allocationCount = 0;
+
+void* operator new(std::size_t size){
+    allocationCount++;
+    if(void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc{};
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Results are folded in here so the compiler cannot drop the work being timed
+static volatile uint64_t sink = 0;
+
+static const char* const positions[][2] = {
+    {"startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"},
+    {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"},
+    {"endgame", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"}
+};
+
+template<typename Operation> void Bench::run(std::string name, double itemsPerOp, Operation operation){
+    using Clock = std::chrono::steady_clock;
+    // Double the iteration count until a run takes long enough to time reliably
+    const double minimumSeconds = 0.2;
+    operation();
+    uint64_t iterations = 1;
+    double seconds = 0;
+    uint64_t allocations = 0;
+    while(true){
+        uint64_t allocationsBefore = allocationCount;
+        auto start = Clock::now();
+        for(uint64_t i = 0; i < iterations; i++){
+            operation();
+        }
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        allocations = allocationCount - allocationsBefore;
+        if(seconds >= minimumSeconds || iterations >= (uint64_t{1} << 40)) break;
+        iterations *= 2;
+    }
+    results.push_back(Result{name, iterations, seconds * 1e9 / iterations, static_cast<double>(allocations) / iterations, itemsPerOp});
+}
+
+void Bench::runAll(){
+    for(const auto &[name, fen] : positions){
+        Position position;
+        position.loadFen(fen);
+        MoveList moves = position.getAllMoves(position.getSideToMove());
+
+        run(std::string{"position_copy/"} + name, 1, [&](){
+            Position copy = position;
+            sink = sink + copy.hash();
+        });
+
+        run(std::string{"get_all_moves/"} + name, moves.size(), [&](){
+            MoveList generated = position.getAllMoves(position.getSideToMove());
+            sink = sink + generated.size();
+        });
+
+        run(std::string{"has_legal_move/"} + name, 1, [&](){
+            sink = sink + position.hasLegalMove(position.getSideToMove());
+        });
+
+        int square = 0;
+        run(std::string{"is_square_attacked/"} + name, 1, [&](){
+            square = (square + 1) & 63;
+            sink = sink + position.isSquareAttacked(square, opposite(position.getSideToMove()));
+        });
+
+        // the table is cleared before each search, so nothing learned carries over between runs
+        SearchOptions options;
+        options.depth = 4;
+        options.hash = 1;
+        Search search{options};
+        run(std::string{"evaluate/"} + name, 1, [&](){
+            sink = sink + search.evaluate(position);
+        });
+
+        Computer computer{position.getSideToMove() == WHITE ? "White" : "Black", 4};
+        Position scratch = position;
+        run(std::string{"level4_move/"} + name, moves.size(), [&](){
+            sink = sink + computer.level4Move(&scratch).from();
+        });
+
+        search.bestMove(scratch);
+        run(std::string{"search_depth4/"} + name, search.getNodes(), [&](){
+            search.clear();
+            sink = sink + search.bestMove(scratch).from();
+        });
+    }
+
+    // Games recorded once with a fixed seed and replayed through executeMove, the position is
+    // reset between games so every op is one in-game move including the end of game checks
+    std::mt19937 generator{2024};
+    std::vector<std::vector<Move>> games;
+    for(int game = 0; game < 8; game++){
+        Position recorder;
+        recorder.loadFen(positions[0][1]);
+        std::vector<Move> played;
+        for(int ply = 0; ply < 120; ply++){
+            MoveList moves = recorder.getAllMoves(recorder.getSideToMove());
+            Move move = moves[std::uniform_int_distribution<size_t>{0, moves.size() - 1}(generator)];
+            recorder.makeMove(move);
+            // stop before any move that would end the game
+            MoveList replies = recorder.getAllMoves(recorder.getSideToMove());
+            if(replies.empty() || recorder.isDeadPosition() || recorder.getFiftyMoveDrawCount() >= 50) break;
+            played.push_back(move);
+        }
+        games.push_back(played);
+    }
+    Chessboard board;
+    size_t game = 0, ply = 0;
+    run("execute_move/random_games", 1, [&](){
+        if(ply == games[game].size()){
+            game = (game + 1) % games.size();
+            ply = 0;
+            board.initChessboard();
+        }
+        board.executeMove(games[game][ply++], board.getPosition().getSideToMove() == WHITE ? "White" : "Black");
+    });
+
+    Position start;
+    start.loadFen(positions[0][1]);
+    uint64_t nodes = start.perft(4);
+    run("perft/startpos_depth4", nodes, [&](){
+        sink = sink + start.perft(4);
+    });
+}
+
+void Bench::runScaling(){
+    // Thread counts double up to the cores available. Every search starts from an empty table, and
+    // the median of three runs is kept since how the threads interleave changes from run to run
+    const int depths[] = {7, 6, 10};
+    int cores = std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, Search::MAX_THREADS);
+    std::vector<int> threadCounts;
+    for(int threads = 1; threads < cores; threads *= 2){
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(cores);
+
+    for(size_t i = 0; i < std::size(positions); i++){
+        Position position;
+        position.loadFen(positions[i][1]);
+        double singleThreaded = 0;
+        for(int threads : threadCounts){
+            SearchOptions options;
+            options.depth = depths[i];
+            options.threads = threads;
+            Search search{options};
+            std::vector<std::pair<double, uint64_t>> runs;
+            for(int run = 0; run < 3; run++){
+                search.clear();
+                auto start = std::chrono::steady_clock::now();
+                search.bestMove(position);
+                runs.push_back({std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), search.getNodes()});
+            }
+            std::sort(runs.begin(), runs.end());
+            auto [seconds, nodes] = runs[1];
+            if(threads == 1){
+                singleThreaded = seconds;
+            }
+            scaling.push_back(ScalingResult{positions[i][0], depths[i], threads, seconds, nodes, singleThreaded / seconds});
+        }
+    }
+}
+
+void Bench::printJson(std::ostream &out) const{
+    out << "{" << std::endl;
+    out << "  \"compiler\": \"" << __VERSION__ << "\"," << std::endl;
+#ifdef __OPTIMIZE__
+    out << "  \"optimized\": true," << std::endl;
+#else
+    out << "  \"optimized\": false," << std::endl;
+#endif
+    out << "  \"benchmarks\": [" << std::endl;
+    for(size_t i = 0; i < results.size(); i++){
+        const Result &r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+            << ", \"ns_per_op\": " << r.nsPerOp << ", \"allocs_per_op\": " << r.allocsPerOp
+            << ", \"ops_per_sec\": " << 1e9 / r.nsPerOp << ", \"items_per_sec\": " << r.itemsPerOp * 1e9 / r.nsPerOp << "}"
+            << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    out << "  ]" << (scaling.empty() ? "" : ",") << std::endl;
+    if(!scaling.empty()){
+        out << "  \"scaling\": [" << std::endl;
+        for(size_t i = 0; i < scaling.size(); i++){
+            const ScalingResult &r = scaling[i];
+            out << "    {\"position\": \"" << r.position << "\", \"depth\": " << r.depth << ", \"threads\": " << r.threads
+                << ", \"seconds\": " << r.seconds << ", \"nodes\": " << r.nodes << ", \"nodes_per_sec\": " << r.nodes / r.seconds
+                << ", \"time_to_depth_speedup\": " << r.speedup << "}" << (i + 1 < scaling.size() ? "," : "") << std::endl;
+        }
+        out << "  ]" << std::endl;
+    }
+    out << "}" << std::endl;
+}
+
+void Bench::printCsv(std::ostream &out) const{
+    if(!results.empty()){
+        out << "name,iterations,ns_per_op,allocs_per_op,ops_per_sec,items_per_sec" << std::endl;
+        for(const Result &r : results){
+            out << r.name << "," << r.iterations << "," << r.nsPerOp << "," << r.allocsPerOp << ","
+                << 1e9 / r.nsPerOp << "," << r.itemsPerOp * 1e9 / r.nsPerOp << std::endl;
+        }
+    }
+    if(!scaling.empty()){
+        out << "position,depth,threads,seconds,nodes,nodes_per_sec,time_to_depth_speedup" << std::endl;
+        for(const ScalingResult &r : scaling){
+            out << r.position << "," << r.depth << "," << r.threads << "," << r.seconds << "," << r.nodes << ","
+                << r.nodes / r.seconds << "," << r.speedup << std::endl;
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdint>
+
+// Fixed-position microbenchmarks for the Position, Chessboard, Computer and Search hot paths,
+// a friend of Computer and Search so private levels and the evaluation can be timed directly
+class Bench {
+    struct Result {
+        std::string name;
+        uint64_t iterations;
+        double nsPerOp;
+        double allocsPerOp;
+        double itemsPerOp;
+    };
+    // Time to reach a fixed depth with a given number of search threads
+    struct ScalingResult {
+        std::string position;
+        int depth;
+        int threads;
+        double seconds;
+        uint64_t nodes;
+        double speedup;
+    };
+    std::vector<Result> results;
+    std::vector<ScalingResult> scaling;
+    template<typename Operation> void run(std::string name, double itemsPerOp, Operation operation);
+    public:
+        void runAll();
+        // Lazy SMP scaling, nodes/s and time to depth from one thread up to every core
+        void runScaling();
+        void printJson(std::ostream &out) const;
+        void printCsv(std::ostream &out) const;
+};
+
+#endif
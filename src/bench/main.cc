@@ -0,0 +1,28 @@
+#include <iostream>
+#include <string>
+#include "Bench.h"
+
+int main(int argc, char* argv[]){
+    // JSON by default, --csv for one row per benchmark, --smp for the search thread scaling report instead
+    bool csv = false;
+    bool smp = false;
+    for(int i = 1; i < argc; i++){
+        csv = csv || std::string{argv[i]} == "--csv";
+        smp = smp || std::string{argv[i]} == "--smp";
+    }
+
+    Bench bench;
+    if(smp){
+        bench.runScaling();
+    }
+    else{
+        bench.runAll();
+    }
+    if(csv){
+        bench.printCsv(std::cout);
+    }
+    else{
+        bench.printJson(std::cout);
+    }
+    return 0;
+}
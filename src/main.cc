@@ -1,6 +1,7 @@
 #include <iostream>
 #include <string>
 #include <memory>
+#include <sstream>
 
 #include "./exceptions/InternalErrorException.h"
 #include "./exceptions/InvalidInputException.h"
@@ -36,12 +37,22 @@ int main(){
     while(std::cin >> command){
         try {
             if(command == "game"){
-                // Start game
-                std::string player1, player2;
-                // Get player information
-                std::cin >> player1;
-                std::cin >> player2;
-                gameManager.startGame(player1, player2);
+                // Start game, each player may be followed by its options: game computer5 depth=6 human
+                std::string line;
+                std::getline(std::cin, line);
+                std::istringstream strm{line};
+                std::string players[2];
+                std::string token;
+                int player = -1;
+                while(strm >> token){
+                    if(token.find('=') != std::string::npos && player >= 0){
+                        players[player] += " " + token;
+                    }
+                    else if(++player < 2){
+                        players[player] = token;
+                    }
+                }
+                gameManager.startGame(players[0], players[1]);
             }
             else if(command == "resign"){
                 // Current player forfeits game
@@ -53,6 +64,14 @@ int main(){
                 std::getline(std::cin, move);
                 gameManager.nextMove(move);
             }
+            else if(command == "undo"){
+                // Take back the last move
+                gameManager.undoMove();
+            }
+            else if(command == "redo"){
+                // Play the last move taken back again
+                gameManager.redoMove();
+            }
             else if(command == "setup"){
                 // Enter setup mode
                 gameManager.setSetupMode(true);
@@ -64,10 +83,22 @@ int main(){
                 std::getline(std::cin, setupCmd);
                 gameManager.runSetupCommand(command + setupCmd);
             }
+            else if(command == "fen"){
+                // Replace the setup board with a FEN position
+                std::string fen;
+                std::getline(std::cin, fen);
+                gameManager.runSetupCommand(command + fen);
+            }
             else if(command == "done"){
                 // Exit setup mode
                 gameManager.runSetupCommand(command);
             }
+            else if(command == "perft"){
+                // Count leaf nodes from the current position
+                std::string args;
+                std::getline(std::cin, args);
+                gameManager.runPerft(args, std::cout);
+            }
         }
         catch(const InternalErrorException& e) { 
             std::cout << e.what() << std::endl;
@@ -0,0 +1,136 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include "../GameManager.h"
+#include "../Position.h"
+#include "../exceptions/InvalidInputException.h"
+
+// Move generation checked against published perft counts, then setup mode checks: each board is built with
+// the same commands main passes on and its perft count compared with the position it should have become,
+// loaded straight from a FEN. No X11 needed.
+
+static int failures = 0;
+
+// The standard perft test positions with their reference counts, depths kept low so make test stays quick
+struct Reference {
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t nodes;
+};
+
+static const Reference references[] = {
+    {"start position", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 4, 197281},
+    {"Kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862},
+    {"position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624},
+    {"position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333},
+    {"position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379},
+};
+
+static void check(bool passed, const std::string &name){
+    std::cout << (passed ? "PASS " : "FAIL ") << name << std::endl;
+    failures += !passed;
+}
+
+// Commands as main hands them to the game manager, e.g. "+ n d5" or "fen 4k3/8/8/8/8/8/8/4K3 w - - 0 1"
+static void setup(GameManager &game, const std::vector<std::string> &commands){
+    game.setSetupMode(true);
+    for(const std::string &command : commands){
+        game.runSetupCommand(command);
+    }
+    game.runSetupCommand("done");
+}
+
+static uint64_t perftOf(const GameManager &game, int depth){
+    Position position = game.getBoard()->getPosition();
+    return position.perft(depth);
+}
+
+static uint64_t perftOf(const std::string &fen, int depth){
+    Position position;
+    position.loadFen(fen);
+    return position.perft(depth);
+}
+
+// Whether the typed move is turned down, the game is started with two humans first
+static bool rejected(GameManager &game, const std::string &move){
+    game.startGame("human", "human");
+    try{
+        game.nextMove(move);
+    }
+    catch(const InvalidInputException &){
+        return true;
+    }
+    return false;
+}
+
+// Whether the command is turned down with an InvalidInputException
+template<typename Command> static bool refused(Command command){
+    try{
+        command();
+    }
+    catch(const InvalidInputException &){
+        return true;
+    }
+    return false;
+}
+
+int main(){
+    for(const Reference &reference : references){
+        uint64_t nodes = perftOf(reference.fen, reference.depth);
+        check(nodes == reference.nodes, std::string{reference.name} + " perft " + std::to_string(reference.depth)
+            + (nodes == reference.nodes ? "" : ": " + std::to_string(nodes) + " instead of " + std::to_string(reference.nodes)));
+    }
+    {
+        // a knight placed on the pawn that just moved two squares takes the en passant capture away
+        GameManager game;
+        setup(game, {"fen 4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", "+ n d5"});
+        check(perftOf(game, 3) == perftOf("4k3/8/8/3nP3/8/8/8/4K3 w - - 0 1", 3), "en passant dropped when the pawn is replaced");
+        check(rejected(game, " e5 d6"), "en passant move rejected after the pawn is replaced");
+    }
+    {
+        GameManager game;
+        setup(game, {"fen 4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", "+ n a1"});
+        check(perftOf(game, 3) == perftOf("4k3/8/8/3pP3/8/8/8/n3K3 w - d6 0 1", 3), "en passant kept after an unrelated edit");
+    }
+    {
+        GameManager game;
+        setup(game, {"fen 4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", "- e5"});
+        check(perftOf(game, 3) == perftOf("4k3/8/8/3p4/8/8/8/4K3 w - - 0 1", 3), "en passant dropped without a pawn to capture");
+    }
+    {
+        // a FEN without castling rights keeps none, whatever else is edited
+        GameManager game;
+        setup(game, {"fen 4k3/8/8/8/8/8/8/R3K2R w - - 0 1", "+ p a7"});
+        check(perftOf(game, 3) == perftOf("4k3/p7/8/8/8/8/8/R3K2R w - - 0 1", 3), "FEN castling rights kept after an edit");
+        check(rejected(game, " e1 g1"), "castling rejected without FEN rights");
+    }
+    {
+        GameManager game;
+        setup(game, {"fen 4k3/8/8/8/8/8/8/R3K2R w KQ - 0 1", "- h1"});
+        check(perftOf(game, 3) == perftOf("4k3/8/8/8/8/8/8/R3K3 w Q - 0 1", 3), "only the right of the edited rook is lost");
+    }
+    {
+        // set up from scratch, kings and rooks on their home squares have not moved
+        GameManager game;
+        setup(game, {"+ K e1", "+ R h1", "+ R a1", "+ k e8", "- a1"});
+        check(perftOf(game, 3) == perftOf("4k3/8/8/8/8/8/8/4K2R w K - 0 1", 3), "castling rights from home squares without a FEN");
+    }
+
+    {
+        // 266 legal moves, more than a move list holds and more queens than promotions could give
+        GameManager game;
+        game.setSetupMode(true);
+        game.runSetupCommand("fen kqQQQQQQ/P1Q4Q/QQ5Q/Q6Q/Q6Q/Q6Q/Q6Q/QQQQQQQK w - - 0 1");
+        std::ostringstream out;
+        check(refused([&]{ game.runPerft("1", out); }), "perft refuses material no game can reach");
+        check(refused([&]{ game.runSetupCommand("done"); }), "done refuses material no game can reach");
+        game.runSetupCommand("fen k7/8/8/8/8/8/NNNNNNNN/NN5K w - - 0 1");
+        check(!refused([&]{ game.runSetupCommand("done"); }), "done accepts promoted knights paid for with pawns");
+    }
+
+    std::cout << (failures ? std::to_string(failures) + " failed" : "All passed") << std::endl;
+    return failures ? 1 : 0;
+}